@@ -1,822 +1,2740 @@
-#include <iostream>  // For standard input and output
-#include <fstream>   // For file input and output
-#include <vector>    // For using the vector container
-#include <cstring>   // Include this header for strcpy
-#include <limits>    // Include this header for std::numeric_limits
-#include <algorithm> // For std::transform
-#include <conio.h>   // To use getch()
-
-#ifdef _WIN32 // If the target platform is Windows
-#include <windows.h>
-#else // If the target platform is not Windows (assumed to be Unix-like)
-#include <unistd.h>
-#endif
-
-// Clear screen based on the platform
-void clearScreen()
-{
-#ifdef _WIN32
-    system("cls"); // clears the output screen on Windows
-#else
-    system("clear"); // clears the output screen on non-Windows systems
-#endif
-}
-
-void sleepForOneSecond(int n)
-{
-#ifdef _WIN32
-    Sleep(n * 1000); // Pause for 1000 milliseconds (1 second)
-#else
-    sleep(n);        // Pause for 1 second
-#endif
-}
-
-// Function to clear input buffer
-void clearInputBuffer()
-{
-    std::cin.clear();
-    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-}
-
-// Utility function to perform case-insensitive string comparison
-bool caseInsensitiveCompareExact(const std::string &str1, const std::string &str2)
-{
-    // Convert both strings to lowercase before comparison
-    std::string str1Lower = str1;
-    std::string str2Lower = str2;
-    std::transform(str1Lower.begin(), str1Lower.end(), str1Lower.begin(), ::tolower);
-    std::transform(str2Lower.begin(), str2Lower.end(), str2Lower.begin(), ::tolower);
-
-    // Use the == operator to compare the transformed strings
-    return str1Lower == str2Lower;
-}
-
-// Function to check if a string contains a substring (case-insensitive)
-bool containsSubstringCaseInsensitive(const std::string &str, const std::string &substr)
-{
-    // Convert both strings to lowercase before comparison
-    std::string strLower = str;
-    std::string substrLower = substr;
-    std::transform(strLower.begin(), strLower.end(), strLower.begin(), ::tolower);
-    std::transform(substrLower.begin(), substrLower.end(), substrLower.begin(), ::tolower);
-    // Use find() to check if the substring exists in the main string
-    return strLower.find(substrLower) != std::string::npos;
-}
-
-void displayMenu()
-{
-    std::cout << "\n\n\t\t\t\t--------------------------------------------------- \n";
-    std::cout << "\t\t\t\t\t   >>> PHONE BOOK MANAGEMENT <<< \n";
-    std::cout << "\t\t\t\t--------------------------------------------------- \n\n";
-    std::cout << "\t\t\t\t1. Show all contacts            2. Search with Name\n\n";
-    std::cout << "\t\t\t\t3. Search with Phone No.        4. Search with Group\n\n";
-    std::cout << "\t\t\t\t5. Add a new contact            6. Modify a contact\n\n";
-    std::cout << "\t\t\t\t7. Delete a contact             8. Delete all contacts\n\n";
-    std::cout << "\t\t\t\t9. Sort by name                 10. Exit\n\n";
-}
-
-// Contact class to hold contact information
-class Contact
-{
-public:
-    char name[50];
-    char phoneNo[15];
-    char email[50];
-    char group[20];
-
-    // Default constructor
-    Contact()
-    {
-        name[0] = '\0';
-        phoneNo[0] = '\0';
-        email[0] = '\0';
-        group[0] = '\0';
-    }
-
-    bool operator<(const Contact &other) const
-    {
-        return std::strcmp(name, other.name) < 0;
-    }
-
-    bool operator==(const Contact &other) const
-    {
-        return std::strcmp(name, other.name) == 0;
-    }
-};
-
-// Phonebook class to manage contacts
-class Phonebook
-{
-private:
-    std::vector<Contact> contacts;
-
-    // Vector to store predefined custom groups
-    std::vector<std::string> customGroups{"Family", "Friend", "Work", "Other"};
-
-    // Method to validate phone number
-    bool isValidPhoneNumber(const char *phoneNo) const
-    {
-        // Check if the phone number is exactly 10 digits and contains only digits
-        return (std::strlen(phoneNo) == 10 && std::strspn(phoneNo, "0123456789") == 10);
-    }
-
-    // Method to validate email
-    bool isValidEmail(char *email) const
-    {
-        // Convert the email to lowercase before comparison
-        std::string emailLower = email;
-        std::transform(emailLower.begin(), emailLower.end(), emailLower.begin(), ::tolower);
-
-        // Case-insensitive comparison with "na"
-        if (emailLower == "na")
-        {
-            return true; // "na" is considered valid
-        }
-
-        // Find the position of the '@' character in the email
-        const char *atPosition = std::strchr(email, '@');
-
-        // Check if the '@' character is missing or if it's at the beginning or the end
-        if (!atPosition || atPosition == email || *(atPosition + 1) == '\0')
-        {
-            // If any of these conditions are met, the email is invalid
-            return false; // No '@' character or '@' is at the beginning or end
-        }
-
-        // Check if the domain is not valid in email
-        const char *domain = atPosition + 1;
-        if (!(std::strstr(domain, "gmail.com") || std::strstr(domain, "yahoo.com") || std::strstr(domain, "email.com")))
-        {
-            return false; // Valid domain not found
-        }
-
-        return true; // Valid email
-    }
-
-    // Method to display group options and get user's choice
-    int getGroupChoice()
-    {
-        std::cout << "Select a group:" << std::endl;
-        for (size_t i = 0; i < customGroups.size(); ++i)
-        {
-            std::cout << i + 1 << ". " << customGroups[i] << std::endl;
-        }
-        std::cout << customGroups.size() + 1 << ". Add your own group" << std::endl;
-
-        int choice = 0;
-
-        while (choice < 1 || choice > customGroups.size() + 1)
-        {
-            std::cout << "Enter your choice: ";
-            char choiceChar;
-            std::cin >> choiceChar;
-            clearInputBuffer();
-
-            choice = choiceChar - '0';
-
-            if (choice < 1 || choice > customGroups.size() + 1)
-            {
-                std::cout << "Invalid choice. Please enter a valid option." << std::endl;
-            }
-        }
-
-        return choice;
-    }
-
-public:
-    // Method to load contacts from a binary file
-    void loadFromFile(const char *filename)
-    {
-        contacts.clear(); // Clear the vector before loading data
-
-        std::ifstream inFile(filename, std::ios::binary | std::ios::in);
-        if (!inFile)
-        {
-            std::cerr << "Error opening file for reading." << std::endl;
-            return;
-        }
-
-        Contact contact;
-        while (inFile.read(reinterpret_cast<char *>(&contact), sizeof(Contact)))
-        {
-            contacts.push_back(contact);
-        }
-
-        inFile.close();
-    }
-
-    // Add a contact to the phonebook
-    void addContact(const Contact &contact)
-    {
-        contacts.push_back(contact);
-    }
-
-    // Save contacts to a binary file
-    void saveToFile(const char *filename)
-    {
-        std::ofstream outFile(filename, std::ios::binary | std::ios::out);
-        if (!outFile)
-        {
-            std::cerr << "Error opening file for writing." << std::endl;
-            return;
-        }
-
-        for (const Contact &contact : contacts)
-        {
-            outFile.write(reinterpret_cast<const char *>(&contact), sizeof(Contact));
-        }
-
-        outFile.close();
-    }
-
-    // Function to add a new contact through user input
-    void addContactFromUserInput()
-    {
-        Contact newContact;
-
-        std::cout << "\n.......CREATE NEW PHONE RECORD.........\n";
-        fflush(stdin); // clears the input buffers like '\n'
-        std::cout << "Name: ";
-        std::cin.getline(newContact.name, sizeof(newContact.name));
-
-        // Input validation for Phone Number
-        bool validPhone = false;
-        do
-        {
-            std::cout << "Phone: ";
-            std::cin.getline(newContact.phoneNo, sizeof(newContact.phoneNo));
-
-            validPhone = isValidPhoneNumber(newContact.phoneNo);
-
-            if (!validPhone)
-            {
-                std::cout << "Invalid phone number. Phone number should be exactly 10 digits and contain only digits." << std::endl;
-            }
-        } while (!validPhone);
-
-        // Input validation for Email
-        bool validEmail = false;
-        do
-        {
-            std::cout << "Email (Enter 'NA' to leave empty): ";
-            std::cin.getline(newContact.email, sizeof(newContact.email));
-
-            // Convert the entered email to uppercase before comparison
-            std::string enteredEmail = newContact.email;
-            std::transform(enteredEmail.begin(), enteredEmail.end(), enteredEmail.begin(), ::toupper);
-
-            // Check if the entered email is "NA" (case-insensitive)
-            if (enteredEmail == "NA")
-            {
-                validEmail = true;
-                std::strcpy(newContact.email, "NA");
-            }
-            else
-            {
-                validEmail = isValidEmail(newContact.email);
-
-                // Truncate the email at ".com" if present
-                char *comPosition = std::strstr(newContact.email, ".com");
-                if (comPosition && *(comPosition + 4) != '\0')
-                {
-                    *(comPosition + 4) = '\0'; // Truncate the string at ".com"
-                }
-
-                if (!validEmail)
-                {
-                    std::cout << "Invalid email. Email should contain @gmail.com, @yahoo.com, or @email.com."
-                              << std::endl;
-                }
-            }
-        } while (!validEmail);
-
-        // Get the group choice from the user
-        int groupChoice = getGroupChoice();
-
-        if (groupChoice == customGroups.size() + 1)
-        {
-            // User wants to add their own group
-            std::string customGroup;
-            std::cout << "Enter your own group: ";
-            std::getline(std::cin, customGroup);
-            customGroups.push_back(customGroup);
-
-            // Set the newContact.group to the custom group
-            std::strcpy(newContact.group, customGroups.back().c_str());
-        }
-        else
-        {
-            // Predefined or custom groups
-            std::strcpy(newContact.group, customGroups[groupChoice - 1].c_str());
-        }
-
-        // Add the new contact to the phonebook
-        addContact(newContact);
-
-        // Save the updated phonebook to file
-        saveToFile("contacts.dat");
-    }
-
-    // Print all contacts
-    void printContacts()
-    {
-        if (contacts.empty())
-        {
-            std::cout << "\nPhonebook is empty." << std::endl;
-            return;
-        }
-
-        // std::cout << "\n...............PHONE BOOK RECORD...............\n";
-        std::cout << "\n\n\t\t\t\t--------------------------------------------------- \n";
-        std::cout << "\t\t\t\t\t   >>> PHONE BOOK RECORD <<< \n";
-        std::cout << "\t\t\t\t--------------------------------------------------- \n\n";
-        for (const Contact &contact : contacts)
-        {
-            std::cout << "\n-----------------------------------" << std::endl;
-            std::cout << "Name: " << contact.name << std::endl;
-            std::cout << "Phone: " << contact.phoneNo << std::endl;
-            std::cout << "Email: " << contact.email << std::endl;
-            std::cout << "Group: " << contact.group << std::endl;
-            std::cout << "-----------------------------------" << std::endl;
-        }
-    }
-
-    // Modify the searchByName function
-    void searchByName(const std::string &name)
-    {
-        if (contacts.empty())
-        {
-            std::cout << "Phonebook is empty. No contacts to search." << std::endl;
-            return;
-        }
-
-        bool found = false;
-        std::cout << "\nSearch Results by Name: " << name << std::endl;
-        for (const Contact &contact : contacts)
-        {
-            // Check if the contact's name contains the partial name (case-insensitive)
-            if (containsSubstringCaseInsensitive(contact.name, name))
-            {
-                found = true;
-                std::cout << "-----------------------------------" << std::endl;
-                std::cout << "Name: " << contact.name << std::endl;
-                std::cout << "Phone: " << contact.phoneNo << std::endl;
-                std::cout << "Email: " << contact.email << std::endl;
-                std::cout << "Group: " << contact.group << std::endl;
-                std::cout << "-----------------------------------" << std::endl;
-            }
-        }
-        if (!found)
-        {
-            std::cout << "No contacts found with the given name." << std::endl;
-        }
-    }
-
-    // Method to search contacts by a part of the phone number
-    void searchByPhoneNumber(const std::string &partialPhoneNo)
-    {
-        if (contacts.empty())
-        {
-            std::cout << "Phonebook is empty. No contacts to search." << std::endl;
-            return;
-        }
-
-        bool found = false;
-        std::cout << "\nSearch Results by Phone Number: " << partialPhoneNo << std::endl;
-        for (const Contact &contact : contacts)
-        {
-            if (std::strstr(contact.phoneNo, partialPhoneNo.c_str()))
-            {
-                found = true;
-                std::cout << "-----------------------------------" << std::endl;
-                std::cout << "Name: " << contact.name << std::endl;
-                std::cout << "Phone: " << contact.phoneNo << std::endl;
-                std::cout << "Email: " << contact.email << std::endl;
-                std::cout << "Group: " << contact.group << std::endl;
-                std::cout << "-----------------------------------" << std::endl;
-            }
-        }
-        if (!found)
-        {
-            std::cout << "No contacts found with the given partial phone number." << std::endl;
-        }
-    }
-
-    // Modify the searchByGroup function
-    void searchByGroup(const std::string &group)
-    {
-        if (contacts.empty())
-        {
-            std::cout << "Phonebook is empty. No contacts to search." << std::endl;
-            return;
-        }
-
-        bool found = false;
-        std::cout << "\nSearch Results by Group: " << group << std::endl;
-        for (const Contact &contact : contacts)
-        {
-            // Check if the contact's group contains the partial group name (case-insensitive)
-            if (containsSubstringCaseInsensitive(contact.group, group))
-            {
-                found = true;
-                std::cout << "-----------------------------------" << std::endl;
-                std::cout << "Name: " << contact.name << std::endl;
-                std::cout << "Phone: " << contact.phoneNo << std::endl;
-                std::cout << "Email: " << contact.email << std::endl;
-                std::cout << "Group: " << contact.group << std::endl;
-                std::cout << "-----------------------------------" << std::endl;
-            }
-        }
-        if (!found)
-        {
-            std::cout << "No contacts found in the given group." << std::endl;
-        }
-    }
-
-    // Method to modify a contact's information
-    void modifyContact(const std::string &name)
-    {
-        if (contacts.empty())
-        {
-            std::cout << "Phonebook is empty. Cannot modify contact." << std::endl;
-            return;
-        }
-
-        bool found = false;
-
-        // Iterate through the contacts to find the contact to be modified
-        for (Contact &contact : contacts)
-        {
-            // Case-insensitive comparison for exact name match
-            if (caseInsensitiveCompareExact(contact.name, name))
-            {
-                found = true;
-
-                // Display the current contact information
-                std::cout << "Current Contact Information:" << std::endl;
-                std::cout << "Name: " << contact.name << std::endl;
-                std::cout << "Phone: " << contact.phoneNo << std::endl;
-                std::cout << "Email: " << contact.email << std::endl;
-                std::cout << "Group: " << contact.group << std::endl;
-
-                // Prompt the user for modification choice
-                char modifyChoice;
-                std::cout << "\nDo you want to modify the entire contact? (y/n): ";
-                std::cin >> modifyChoice;
-
-                clearInputBuffer(); // Clear input buffer after reading choice
-
-                if (modifyChoice == 'y' || modifyChoice == 'Y')
-                {
-                    // Modify the entire contact
-                    std::cout << "Enter new information for the contact:" << std::endl;
-                    std::cout << "Name: ";
-                    std::cin.getline(contact.name, sizeof(contact.name));
-
-                    // Validate the new phone number
-                    bool validPhone = false;
-                    do
-                    {
-                        std::cout << "Enter new phone number: ";
-                        std::cin.getline(contact.phoneNo, sizeof(contact.phoneNo));
-
-                        validPhone = isValidPhoneNumber(contact.phoneNo);
-
-                        if (!validPhone)
-                        {
-                            std::cout << "Invalid phone number. Phone number should be exactly 10 digits and contain only digits." << std::endl;
-                        }
-                    } while (!validPhone);
-
-                    // Validate the new email
-                    bool validEmail = false;
-                    do
-                    {
-                        std::cout << "Enter new email: ";
-                        std::cin.getline(contact.email, sizeof(contact.email));
-
-                        // Convert the entered email to uppercase before comparison
-                        std::string enteredEmail = contact.email;
-                        std::transform(enteredEmail.begin(), enteredEmail.end(), enteredEmail.begin(), ::toupper);
-
-                        // Check if the entered email is "NA" (case-insensitive)
-                        if (enteredEmail == "NA")
-                        {
-                            validEmail = true;
-                            std::strcpy(contact.email, "NA");
-                        }
-                        else
-                        {
-                            validEmail = isValidEmail(contact.email);
-
-                            // Truncate the email at ".com" if present
-                            char *comPosition = std::strstr(contact.email, ".com");
-                            if (comPosition && *(comPosition + 4) != '\0')
-                            {
-                                *(comPosition + 4) = '\0'; // Truncate the string at ".com"
-                            }
-
-                            if (!validEmail)
-                            {
-                                std::cout << "Invalid email. Email should contain @gmail.com, @yahoo.com, or @email.com."
-                                          << std::endl;
-                            }
-                        }
-                    } while (!validEmail);
-
-                    int groupChoice = getGroupChoice();
-                    if (groupChoice == customGroups.size() + 1)
-                    {
-                        // User wants to add their own group
-                        std::cout << "Enter your own group: ";
-                        std::cin.getline(contact.group, sizeof(contact.group));
-                        customGroups.push_back(contact.group);
-                    }
-                    else
-                    {
-                        std::strcpy(contact.group, customGroups[groupChoice - 1].c_str());
-                    }
-                }
-                else
-                {
-                    // Modify specific parts of the contact
-                    std::cout << "Choose the part you want to modify:" << std::endl;
-                    std::cout << "1. Name" << std::endl;
-                    std::cout << "2. Phone" << std::endl;
-                    std::cout << "3. Email" << std::endl;
-                    std::cout << "4. Group" << std::endl;
-                    std::cout << "Enter your choice: ";
-                    char partChoice;
-                    std::cin >> partChoice;
-                    clearInputBuffer();
-
-                    switch (partChoice)
-                    {
-                    case '1':
-                        std::cout << "Enter new name: ";
-                        std::cin.getline(contact.name, sizeof(contact.name));
-                        break;
-                    case '2':
-                    {
-                        // Validate the new phone number
-                        bool validPhone = false;
-                        do
-                        {
-                            std::cout << "Enter new phone number: ";
-                            std::cin.getline(contact.phoneNo, sizeof(contact.phoneNo));
-
-                            validPhone = isValidPhoneNumber(contact.phoneNo);
-
-                            if (!validPhone)
-                            {
-                                std::cout << "Invalid phone number. Phone number should be exactly 10 digits and contain only digits." << std::endl;
-                            }
-                        } while (!validPhone);
-                    }
-                    break;
-                    case '3':
-                    {
-                        // Validate the new email
-                        bool validEmail = false;
-                        do
-                        {
-                            std::cout << "Enter new email: ";
-                            std::cin.getline(contact.email, sizeof(contact.email));
-
-                            // Convert the entered email to uppercase before comparison
-                            std::string enteredEmail = contact.email;
-                            std::transform(enteredEmail.begin(), enteredEmail.end(), enteredEmail.begin(), ::toupper);
-
-                            // Check if the entered email is "NA" (case-insensitive)
-                            if (enteredEmail == "NA")
-                            {
-                                validEmail = true;
-                                std::strcpy(contact.email, "NA");
-                            }
-                            else
-                            {
-                                validEmail = isValidEmail(contact.email);
-
-                                // Truncate the email at ".com" if present
-                                char *comPosition = std::strstr(contact.email, ".com");
-                                if (comPosition && *(comPosition + 4) != '\0')
-                                {
-                                    *(comPosition + 4) = '\0'; // Truncate the string at ".com"
-                                }
-
-                                if (!validEmail)
-                                {
-                                    std::cout << "Invalid email. Email should contain @gmail.com, @yahoo.com, or @email.com."
-                                              << std::endl;
-                                }
-                            }
-                        } while (!validEmail);
-                    }
-                    break;
-                    case '4':
-                    {
-                        int groupChoice = getGroupChoice();
-                        if (groupChoice == customGroups.size() + 1)
-                        {
-                            // User wants to add their own group
-                            std::cout << "Enter your own group: ";
-                            std::cin.getline(contact.group, sizeof(contact.group));
-                            customGroups.push_back(contact.group);
-                        }
-                        else
-                        {
-                            std::strcpy(contact.group, customGroups[groupChoice - 1].c_str());
-                        }
-                    }
-                    break;
-                    default:
-                        std::cout << "Invalid choice. Contact not modified." << std::endl;
-                        break;
-                    }
-                }
-
-                // Save the modified phonebook to file
-                saveToFile("contacts.dat");
-
-                std::cout << "\nContact information has been modified." << std::endl;
-                break; // Exit the loop once the contact is modified
-            }
-        }
-
-        if (!found)
-        {
-            std::cout << "\nNo contact found with the given name." << std::endl;
-        }
-    }
-
-    // Method to delete a contact by name
-    void deleteContact(const std::string &name)
-    {
-        // Check if the phonebook is already empty
-        if (contacts.empty())
-        {
-            std::cout << "\nPhonebook is already empty. No contacts to delete." << std::endl;
-            return;
-        }
-
-        // Use the remove_if algorithm to move contacts to be deleted to the end of the vector
-        auto iter = std::remove_if(contacts.begin(), contacts.end(), [&name](const Contact &contact)
-                                   { return caseInsensitiveCompareExact(contact.name, name); });
-
-        // Check if any contact was found and marked for deletion
-        if (iter != contacts.end())
-        {
-            // Erase the contacts marked for deletion from the vector
-            contacts.erase(iter, contacts.end());
-            std::cout << "\nContact '" << name << "' has been deleted." << std::endl;
-
-            // Save the updated phonebook to file
-            saveToFile("contacts.dat");
-        }
-        else
-        {
-            // No matching contact found for deletion
-            std::cout << "\nNo contact found with the given name." << std::endl;
-        }
-    }
-
-    // Method to delete all contacts
-    void deleteAllContacts()
-    {
-        if (contacts.empty())
-        {
-            std::cout << "\nPhonebook is already empty. No contacts to delete." << std::endl;
-            return;
-        }
-
-        contacts.clear();
-        std::cout << "\nAll contacts have been deleted." << std::endl;
-        saveToFile("contacts.dat"); // Save the empty phonebook to file
-    }
-
-    // Method to sort all contacts by name
-    void sortContactsByName()
-    {
-        std::sort(contacts.begin(), contacts.end());
-    }
-};
-
-int main()
-{
-    system("color 0A");
-    Phonebook phonebook;
-
-    int choice;
-    std::string searchName;
-    std::string partialPhoneNo;
-    std::string searchGroup;
-    std::string modifyName;
-    std::string deleteName;
-
-    // Load existing contacts from the file
-    phonebook.loadFromFile("contacts.dat");
-
-    // Sort contacts by name
-    phonebook.sortContactsByName();
-
-    do
-    {
-        clearScreen();
-        displayMenu();
-
-        // Getting user's choice
-        std::cout << "Enter your choice: ";
-        std::cin >> choice;
-
-        if (std::cin.fail())
-        {
-            clearScreen();
-            std::cout << "Invalid choice. Please enter a valid option.\n";
-            sleepForOneSecond(1);
-            clearInputBuffer(); // Clear input buffer
-            continue;
-        }
-
-        clearInputBuffer(); // Clear input buffer after reading choice
-
-        switch (choice)
-        {
-        case 1:
-            // Show all contacts
-            phonebook.printContacts();
-            std::cout << "\n\n-> Press any key to continue : ";
-            getch();
-            break;
-        case 2:
-            // Search by Name
-            std::cout << "Enter name to search: ";
-            std::getline(std::cin, searchName);
-            phonebook.searchByName(searchName);
-            std::cout << "\n\n-> Press any key to continue : ";
-            getch();
-            break;
-        case 3:
-            // Search by Partial Phone Number
-            std::cout << "Enter partial phone number to search: ";
-            std::getline(std::cin, partialPhoneNo);
-            phonebook.searchByPhoneNumber(partialPhoneNo);
-            std::cout << "\n\n-> Press any key to continue : ";
-            getch();
-            break;
-        case 4:
-            // Search by Group
-            std::cout << "Enter group to search: ";
-            std::getline(std::cin, searchGroup);
-            phonebook.searchByGroup(searchGroup);
-            std::cout << "\n\n-> Press any key to continue : ";
-            getch();
-            break;
-        case 5:
-            // Add a new contact
-            phonebook.addContactFromUserInput();
-            break;
-        case 6:
-            // Modify a contact
-            std::cout << "Enter the name of the contact to modify: ";
-            std::getline(std::cin, modifyName);
-            phonebook.modifyContact(modifyName);
-            std::cout << "\n\n-> Press any key to continue : ";
-            getch();
-            break;
-        case 7:
-            // Delete a contact
-            std::cout << "Enter the name of the contact to delete: ";
-            std::getline(std::cin, deleteName);
-            phonebook.deleteContact(deleteName);
-            std::cout << "\n\n-> Press any key to continue : ";
-            getch();
-            break;
-        case 8:
-            // Delete all contacts
-            phonebook.deleteAllContacts();
-            std::cout << "\n\n-> Press any key to continue : ";
-            getch();
-            break;
-        case 9:
-            // Sort contacts by name
-            phonebook.sortContactsByName();
-            std::cout << "\nContacts sorted by name." << std::endl;
-            std::cout << "\n\n-> Press any key to continue : ";
-            getch();
-            break;
-        case 10:
-            // Exit the program
-            clearScreen();
-            std::cout << "\n\n---------Exiting the Phonebook---------\n\n";
-            sleepForOneSecond(1);
-            break;
-        default:
-            clearScreen();
-            std::cout << "Invalid choice. Please enter a valid option.\n";
-            sleepForOneSecond(1);
-            break;
-        }
-    } while (choice != 10);
-
-    return 0;
-}
+#include <iostream>  // For standard input and output
+#include <fstream>   // For file input and output
+#include <vector>    // For using the vector container
+#include <cstring>   // Include this header for strcpy
+#include <cstddef>   // For offsetof
+#include <limits>    // Include this header for std::numeric_limits
+#include <algorithm> // For std::transform
+#include <string>    // For std::string and std::to_string
+#include <thread>    // For loading, saving and searching shards in parallel
+#include <cstdint>   // For fixed-width hash values
+#include <atomic>    // For publishing background load progress
+#include <memory>    // For atomically swapped name indexes and the contact allocator
+#include <array>     // For the email domain dispatch table
+#include <list>      // For the query cache's recency list
+#include <unordered_map> // For looking up cached queries
+#include <conio.h>   // To use getch()
+
+#ifdef _WIN32 // If the target platform is Windows
+#include <windows.h>
+#else // If the target platform is not Windows (assumed to be Unix-like)
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h> // For checking 16 phone number bytes at once
+#define PHONEBOOK_HAVE_SSE2 1
+#endif
+
+// Clear screen based on the platform
+void clearScreen()
+{
+#ifdef _WIN32
+    system("cls"); // clears the output screen on Windows
+#else
+    system("clear"); // clears the output screen on non-Windows systems
+#endif
+}
+
+void sleepForOneSecond(int n)
+{
+#ifdef _WIN32
+    Sleep(n * 1000); // Pause for 1000 milliseconds (1 second)
+#else
+    sleep(n);        // Pause for 1 second
+#endif
+}
+
+// Function to clear input buffer
+void clearInputBuffer()
+{
+    std::cin.clear();
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+}
+
+void displayMenu()
+{
+    std::cout << "\n\n\t\t\t\t--------------------------------------------------- \n";
+    std::cout << "\t\t\t\t\t   >>> PHONE BOOK MANAGEMENT <<< \n";
+    std::cout << "\t\t\t\t--------------------------------------------------- \n\n";
+    std::cout << "\t\t\t\t1. Show all contacts            2. Search with Name\n\n";
+    std::cout << "\t\t\t\t3. Search with Phone No.        4. Search with Group\n\n";
+    std::cout << "\t\t\t\t5. Add a new contact            6. Modify a contact\n\n";
+    std::cout << "\t\t\t\t7. Delete a contact             8. Delete all contacts\n\n";
+    std::cout << "\t\t\t\t9. Sort by name                 10. Exit\n\n";
+}
+
+// Contact class to hold contact information
+class Contact
+{
+public:
+    char name[50];
+    char phoneNo[15];
+    char email[50];
+    char group[20];
+
+    // Default constructor
+    Contact()
+    {
+        name[0] = '\0';
+        phoneNo[0] = '\0';
+        email[0] = '\0';
+        group[0] = '\0';
+    }
+
+    bool operator<(const Contact &other) const
+    {
+        return std::strcmp(name, other.name) < 0;
+    }
+
+    bool operator==(const Contact &other) const
+    {
+        return std::strcmp(name, other.name) == 0;
+    }
+};
+
+// Allocator that leaves default-constructed elements as raw memory, so a shard can be sized for a
+// large file without touching every page first; the loader fills (or zeroes) each chunk it reads
+template <typename T>
+struct UninitializedAllocator : std::allocator<T>
+{
+    template <typename U>
+    struct rebind
+    {
+        using other = UninitializedAllocator<U>;
+    };
+
+    UninitializedAllocator() = default;
+
+    template <typename U>
+    UninitializedAllocator(const UninitializedAllocator<U> &) {}
+
+    template <typename U>
+    void construct(U *) noexcept
+    {
+    }
+
+    template <typename U, typename... Args>
+    void construct(U *place, Args &&...args)
+    {
+        ::new (static_cast<void *>(place)) U(std::forward<Args>(args)...);
+    }
+};
+
+// Contacts of a shard, in slot order
+using ContactList = std::vector<Contact, UninitializedAllocator<Contact>>;
+
+// Reasons a record can fail validation; every record's failures are reported as a bitmap of these
+enum ValidationFailure : std::uint8_t
+{
+    PhoneWrongLength = 1 << 0,      // Phone number is not exactly 10 characters
+    PhoneNotDigits = 1 << 1,        // Phone number contains something other than digits
+    EmailMalformed = 1 << 2,        // No '@', or '@' at the beginning or the end
+    EmailDomainNotAllowed = 1 << 3, // Domain does not contain any allowed domain
+};
+
+// Set of allowed email domains, compiled into a first-byte dispatch table so a domain is scanned only once
+class DomainMatcher
+{
+private:
+    std::vector<std::string> allowed;
+
+    // Indices into allowed, grouped by the first byte of the domain
+    std::array<std::vector<std::uint8_t>, 256> byFirstByte;
+
+public:
+    // Domains are numbered with a byte in the dispatch table; callers reject longer lists
+    static constexpr size_t maxDomains = 256;
+
+    explicit DomainMatcher(const std::vector<std::string> &domains)
+    {
+        for (const std::string &domain : domains)
+        {
+            if (!domain.empty() && allowed.size() < maxDomains)
+            {
+                byFirstByte[static_cast<unsigned char>(domain[0])].push_back(static_cast<std::uint8_t>(allowed.size()));
+                allowed.push_back(domain);
+            }
+        }
+    }
+
+    const std::vector<std::string> &domains() const
+    {
+        return allowed;
+    }
+
+    // Check if the domain part of an email contains any allowed domain
+    bool matches(const char *domain) const
+    {
+        for (const char *position = domain; *position != '\0'; ++position)
+        {
+            for (std::uint8_t candidate : byFirstByte[static_cast<unsigned char>(*position)])
+            {
+                const std::string &allowedDomain = allowed[candidate];
+                if (std::strncmp(position, allowedDomain.c_str(), allowedDomain.size()) == 0)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+};
+
+// Validation failures of a phone number, 0 if it is exactly 10 digits
+inline std::uint8_t phoneFailures(const char *phoneNo, size_t maxLength)
+{
+    size_t length = 0;
+    size_t digits = 0;
+    for (; length < maxLength && phoneNo[length] != '\0'; ++length)
+    {
+        digits += (phoneNo[length] >= '0' && phoneNo[length] <= '9') ? 1 : 0;
+    }
+
+    std::uint8_t failures = 0;
+    if (length != 10)
+    {
+        failures |= PhoneWrongLength;
+    }
+    if (digits != length)
+    {
+        failures |= PhoneNotDigits;
+    }
+    return failures;
+}
+
+// "NA" (any case) means the email was left empty
+inline bool isEmailNotAvailable(const char *email)
+{
+    return (email[0] == 'n' || email[0] == 'N') && (email[1] == 'a' || email[1] == 'A') && email[2] == '\0';
+}
+
+// Validation failures of an email, 0 if it is "NA" or an address at an allowed domain
+inline std::uint8_t emailFailures(const char *email, size_t maxLength, const DomainMatcher &domains)
+{
+    if (isEmailNotAvailable(email))
+    {
+        return 0;
+    }
+
+    // Find the position of the '@' character in the email
+    const void *terminator = std::memchr(email, '\0', maxLength);
+    size_t length = terminator ? static_cast<const char *>(terminator) - email : maxLength;
+    const char *atPosition = static_cast<const char *>(std::memchr(email, '@', length));
+
+    // Check if the '@' character is missing or if it's at the beginning or the end
+    if (!atPosition || atPosition == email || atPosition + 1 == email + length)
+    {
+        return EmailMalformed;
+    }
+
+    return domains.matches(atPosition + 1) ? 0 : EmailDomainNotAllowed;
+}
+
+// Compile-time description of a Contact field: where it lives, how long it may be and how it is compared
+template <size_t Offset, size_t Length, bool CaseFolded>
+struct FieldDescriptor
+{
+    static constexpr size_t offset = Offset;
+    static constexpr size_t maxLength = Length; // Buffer size including the terminating '\0'
+    static constexpr bool caseFolded = CaseFolded;
+
+    static char *data(Contact &contact)
+    {
+        return reinterpret_cast<char *>(&contact) + offset;
+    }
+
+    static const char *data(const Contact &contact)
+    {
+        return reinterpret_cast<const char *>(&contact) + offset;
+    }
+
+    // Fold a character according to the field's case rules
+    static char fold(char c)
+    {
+        return CaseFolded ? static_cast<char>(std::tolower(static_cast<unsigned char>(c))) : c;
+    }
+
+    // Fields are accepted as typed unless a descriptor says otherwise
+    static bool validate(const char *)
+    {
+        return true;
+    }
+
+    static void normalize(char *)
+    {
+    }
+
+    static std::string invalidMessage()
+    {
+        return "";
+    }
+};
+
+struct NameField : FieldDescriptor<offsetof(Contact, name), sizeof(Contact::name), true>
+{
+    static constexpr unsigned id = 0;
+    static constexpr const char *label = "Name";
+};
+
+struct PhoneField : FieldDescriptor<offsetof(Contact, phoneNo), sizeof(Contact::phoneNo), false>
+{
+    static constexpr unsigned id = 1;
+    static constexpr const char *label = "Phone";
+
+    // Check if the phone number is exactly 10 digits and contains only digits
+    static bool validate(const char *phoneNo)
+    {
+        return phoneFailures(phoneNo, maxLength) == 0;
+    }
+
+    static std::string invalidMessage()
+    {
+        return "Invalid phone number. Phone number should be exactly 10 digits and contain only digits.";
+    }
+};
+
+struct EmailField : FieldDescriptor<offsetof(Contact, email), sizeof(Contact::email), true>
+{
+    static constexpr unsigned id = 2;
+    static constexpr const char *label = "Email";
+
+    // Allowed domains shared by every email check; replace them with setAllowedDomains before loading
+    static DomainMatcher &allowedDomains()
+    {
+        static DomainMatcher matcher({"gmail.com", "yahoo.com", "email.com"});
+        return matcher;
+    }
+
+    static void setAllowedDomains(const std::vector<std::string> &domains)
+    {
+        allowedDomains() = DomainMatcher(domains);
+    }
+
+    static bool validate(const char *email)
+    {
+        return emailFailures(email, maxLength, allowedDomains()) == 0;
+    }
+
+    // Store "NA" in upper case and truncate the email at ".com" if present
+    static void normalize(char *email)
+    {
+        if (isEmailNotAvailable(email))
+        {
+            std::strcpy(email, "NA");
+            return;
+        }
+
+        char *comPosition = std::strstr(email, ".com");
+        if (comPosition && *(comPosition + 4) != '\0')
+        {
+            *(comPosition + 4) = '\0'; // Truncate the string at ".com"
+        }
+    }
+
+    // List the allowed domains, e.g. "@gmail.com, @yahoo.com, or @email.com"
+    static std::string invalidMessage()
+    {
+        const std::vector<std::string> &domains = allowedDomains().domains();
+        std::string message = "Invalid email. Email should contain ";
+        for (size_t i = 0; i < domains.size(); ++i)
+        {
+            if (i > 0)
+            {
+                message += (domains.size() > 2 ? ", " : " ");
+                message += (i + 1 == domains.size() ? "or " : "");
+            }
+            message += "@" + domains[i];
+        }
+        return message + ".";
+    }
+};
+
+struct GroupField : FieldDescriptor<offsetof(Contact, group), sizeof(Contact::group), true>
+{
+    static constexpr unsigned id = 3;
+    static constexpr const char *label = "Group";
+};
+
+// Validate the phone number and email of many records at once; failures[i] receives the
+// ValidationFailure bits of records[i]. Phone numbers are checked 16 bytes at a time where SSE2 is available.
+inline void validateContacts(const Contact *records, size_t count, std::uint8_t *failures)
+{
+    const DomainMatcher &domains = EmailField::allowedDomains();
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Contact &record = records[i];
+#ifdef PHONEBOOK_HAVE_SSE2
+        // phoneNo is 15 bytes followed by email, so a 16-byte load stays inside the record
+        static_assert(offsetof(Contact, phoneNo) + 16 <= sizeof(Contact), "phone load must stay inside Contact");
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(record.phoneNo));
+        __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)),
+                                        _mm_cmplt_epi8(bytes, _mm_set1_epi8('9' + 1)));
+        unsigned digitMask = static_cast<unsigned>(_mm_movemask_epi8(isDigit));
+        unsigned zeroMask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_setzero_si128())));
+
+        // An unterminated field counts as 15 characters long
+        zeroMask = (zeroMask & 0x7FFF) | 0x8000;
+        unsigned length = 0;
+        while (!(zeroMask & (1u << length)))
+        {
+            ++length;
+        }
+        unsigned lengthMask = (1u << length) - 1;
+
+        std::uint8_t recordFailures = 0;
+        if (length != 10)
+        {
+            recordFailures |= PhoneWrongLength;
+        }
+        if ((digitMask & lengthMask) != lengthMask)
+        {
+            recordFailures |= PhoneNotDigits;
+        }
+#else
+        std::uint8_t recordFailures = phoneFailures(record.phoneNo, sizeof(record.phoneNo));
+#endif
+        recordFailures |= emailFailures(record.email, sizeof(record.email), domains);
+        failures[i] = recordFailures;
+    }
+}
+
+// Call fn once per field descriptor, in record order; every call is instantiated for its own field
+template <typename Fn>
+void forEachField(Fn fn)
+{
+    fn(NameField());
+    fn(PhoneField());
+    fn(EmailField());
+    fn(GroupField());
+}
+
+// Number of fields and a mask with one bit per field id
+const unsigned contactFieldCount = 4;
+const unsigned allContactFields = (1u << contactFieldCount) - 1;
+
+// Bitmask of the fields (by id) whose values differ between two versions of a contact
+inline unsigned changedFields(const Contact &before, const Contact &after)
+{
+    unsigned mask = 0;
+    forEachField([&before, &after, &mask](auto field)
+                 {
+        using Field = decltype(field);
+        if (std::strncmp(Field::data(before), Field::data(after), Field::maxLength) != 0)
+        {
+            mask |= 1u << Field::id;
+        } });
+    return mask;
+}
+
+// Fold a search term once so the per-record loop only has to fold the field side
+template <typename Field>
+std::string foldQuery(const std::string &query)
+{
+    std::string folded = query;
+    for (char &c : folded)
+    {
+        c = Field::fold(c);
+    }
+    return folded;
+}
+
+// Check if a field exactly equals the query under the field's case rules
+template <typename Field>
+bool fieldEquals(const Contact &contact, const std::string &query)
+{
+    const char *value = Field::data(contact);
+    size_t length = 0;
+    for (; length < Field::maxLength && value[length] != '\0'; ++length)
+    {
+        if (length >= query.size() || Field::fold(value[length]) != Field::fold(query[length]))
+        {
+            return false;
+        }
+    }
+    return length == query.size();
+}
+
+// Check if a field contains an already folded search term under the field's case rules
+template <typename Field>
+bool fieldContains(const Contact &contact, const std::string &foldedQuery)
+{
+    const char *value = Field::data(contact);
+    const void *terminator = std::memchr(value, '\0', Field::maxLength);
+    size_t length = terminator ? static_cast<const char *>(terminator) - value : Field::maxLength;
+
+    for (size_t start = 0; start + foldedQuery.size() <= length; ++start)
+    {
+        size_t matched = 0;
+        while (matched < foldedQuery.size() && Field::fold(value[start + matched]) == foldedQuery[matched])
+        {
+            ++matched;
+        }
+        if (matched == foldedQuery.size())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Order contacts by one field, byte by byte like strcmp
+template <typename Field>
+struct FieldLess
+{
+    bool operator()(const Contact &a, const Contact &b) const
+    {
+        return std::strncmp(Field::data(a), Field::data(b), Field::maxLength) < 0;
+    }
+};
+
+// Run fn(i) for every i in [0, count) spread over all cores
+template <typename Fn>
+void parallelFor(size_t count, Fn fn)
+{
+    size_t threadCount = std::min<size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+    std::atomic<size_t> next{0};
+    auto worker = [&next, &fn, count]()
+    {
+        size_t i;
+        while ((i = next++) < count)
+        {
+            fn(i);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threadCount; ++t)
+    {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : workers)
+    {
+        thread.join();
+    }
+}
+
+// Compressed snapshots group records into blocks that are compressed, checksummed and indexed
+// independently, so blocks decode in parallel and one record can be read without decompressing
+// the rest of the file. Layout, all integers little-endian:
+//   header: "PBSNAP1\0", u32 recordsPerBlock, u32 blockCount, u64 recordCount
+//   index:  per block u64 offset, u32 compressedSize, u32 rawSize, u32 recordCount, u32 CRC-32 of the raw bytes
+//   u32 CRC-32 of the header and index
+//   blocks: LZ-compressed records, every field stored up to and including its '\0'
+// Every block but the last holds exactly recordsPerBlock records.
+const char snapshotMagic[8] = {'P', 'B', 'S', 'N', 'A', 'P', '1', '\0'};
+const size_t snapshotHeaderSize = 24;
+const size_t snapshotIndexEntrySize = 24;
+const std::uint32_t snapshotBlockRecords = 512;
+const std::uint32_t snapshotMaxBlockRecords = 65536; // Largest block a reader accepts
+
+struct SnapshotBlock
+{
+    std::uint64_t offset;
+    std::uint32_t compressedSize;
+    std::uint32_t rawSize;
+    std::uint32_t recordCount;
+    std::uint32_t checksum;
+};
+
+inline void appendU32(std::string &out, std::uint32_t value)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        out += static_cast<char>((value >> shift) & 0xFF);
+    }
+}
+
+inline void appendU64(std::string &out, std::uint64_t value)
+{
+    appendU32(out, static_cast<std::uint32_t>(value));
+    appendU32(out, static_cast<std::uint32_t>(value >> 32));
+}
+
+inline std::uint32_t readU32(const char *in)
+{
+    std::uint32_t value = 0;
+    for (int i = 3; i >= 0; --i)
+    {
+        value = (value << 8) | static_cast<unsigned char>(in[i]);
+    }
+    return value;
+}
+
+inline std::uint64_t readU64(const char *in)
+{
+    return readU32(in) | (static_cast<std::uint64_t>(readU32(in + 4)) << 32);
+}
+
+// CRC-32 (IEEE) of a byte range
+inline std::uint32_t crc32(const char *data, size_t size)
+{
+    static const std::array<std::uint32_t, 256> table = []()
+    {
+        std::array<std::uint32_t, 256> entries{};
+        for (std::uint32_t i = 0; i < 256; ++i)
+        {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320u : 0);
+            }
+            entries[i] = crc;
+        }
+        return entries;
+    }();
+
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i)
+    {
+        crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// LZ77 coder in the LZ4 block style: each sequence is a token (literal count in the high nibble,
+// match length - 4 in the low nibble, 15 meaning more length bytes follow), the literals, then a
+// 2-byte match offset. The last sequence carries literals only.
+inline void lzCompress(const std::string &input, std::string &output)
+{
+    const size_t minMatch = 4;
+    const size_t maxOffset = 65535;
+    std::vector<std::int64_t> table(4096, -1); // Last position of every hashed 4-byte sequence
+
+    auto appendLength = [&output](size_t length)
+    {
+        while (length >= 255)
+        {
+            output += static_cast<char>(255);
+            length -= 255;
+        }
+        output += static_cast<char>(length);
+    };
+    auto appendLiterals = [&output, &input, &appendLength](size_t anchor, size_t literals, unsigned matchNibble)
+    {
+        output += static_cast<char>((std::min<size_t>(literals, 15) << 4) | matchNibble);
+        if (literals >= 15)
+        {
+            appendLength(literals - 15);
+        }
+        output.append(input, anchor, literals);
+    };
+
+    size_t anchor = 0;
+    size_t position = 0;
+    while (position + minMatch <= input.size())
+    {
+        std::uint32_t sequence;
+        std::memcpy(&sequence, &input[position], sizeof(sequence));
+        size_t hash = (sequence * 2654435761u) >> 20;
+        std::int64_t candidate = table[hash];
+        table[hash] = static_cast<std::int64_t>(position);
+
+        if (candidate < 0 || position - candidate > maxOffset || std::memcmp(&input[candidate], &input[position], minMatch) != 0)
+        {
+            ++position;
+            continue;
+        }
+
+        size_t length = minMatch;
+        while (position + length < input.size() && input[candidate + length] == input[position + length])
+        {
+            ++length;
+        }
+
+        size_t offset = position - candidate;
+        appendLiterals(anchor, position - anchor, static_cast<unsigned>(std::min<size_t>(length - minMatch, 15)));
+        output += static_cast<char>(offset & 0xFF);
+        output += static_cast<char>(offset >> 8);
+        if (length - minMatch >= 15)
+        {
+            appendLength(length - minMatch - 15);
+        }
+
+        position += length;
+        anchor = position;
+    }
+
+    appendLiterals(anchor, input.size() - anchor, 0);
+}
+
+// Decode lzCompress output, returns false if the data is malformed or not exactly rawSize bytes long
+inline bool lzDecompress(const char *input, size_t size, std::string &output, size_t rawSize)
+{
+    output.clear();
+    output.reserve(rawSize);
+
+    size_t position = 0;
+    auto readLength = [input, size, &position](size_t &length)
+    {
+        unsigned char byte;
+        do
+        {
+            if (position >= size)
+            {
+                return false;
+            }
+            byte = static_cast<unsigned char>(input[position++]);
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    while (position < size)
+    {
+        unsigned char token = static_cast<unsigned char>(input[position++]);
+        size_t literals = token >> 4;
+        if ((literals == 15 && !readLength(literals)) || literals > size - position || output.size() + literals > rawSize)
+        {
+            return false;
+        }
+        output.append(input + position, literals);
+        position += literals;
+
+        if (position == size)
+        {
+            break; // Last sequence
+        }
+
+        if (size - position < 2)
+        {
+            return false;
+        }
+        size_t offset = static_cast<unsigned char>(input[position]) | (static_cast<unsigned char>(input[position + 1]) << 8);
+        position += 2;
+
+        size_t length = token & 15;
+        if (length == 15 && !readLength(length))
+        {
+            return false;
+        }
+        length += 4;
+        if (offset == 0 || offset > output.size() || output.size() + length > rawSize)
+        {
+            return false;
+        }
+
+        // Byte by byte, since a match may overlap the bytes it produces
+        size_t from = output.size() - offset;
+        for (size_t i = 0; i < length; ++i)
+        {
+            output += output[from + i];
+        }
+    }
+    return output.size() == rawSize;
+}
+
+// Append a record to a snapshot block, every field up to and including its terminator
+inline void serializeRecord(const Contact &contact, std::string &out)
+{
+    forEachField([&contact, &out](auto field)
+                 {
+        using Field = decltype(field);
+        const char *value = Field::data(contact);
+        const void *terminator = std::memchr(value, '\0', Field::maxLength);
+        size_t length = terminator ? static_cast<const char *>(terminator) - value : Field::maxLength - 1;
+        out.append(value, length);
+        out += '\0'; });
+}
+
+// Read records written by serializeRecord, returns false if the block does not hold exactly count of them
+inline bool parseRecords(const std::string &raw, size_t count, Contact *records)
+{
+    size_t position = 0;
+    bool valid = true;
+    for (size_t i = 0; i < count && valid; ++i)
+    {
+        Contact &contact = records[i];
+        std::memset(static_cast<void *>(&contact), 0, sizeof(Contact));
+        forEachField([&raw, &position, &contact, &valid](auto field)
+                     {
+            using Field = decltype(field);
+            size_t terminator = raw.find('\0', position);
+            if (!valid || terminator == std::string::npos || terminator - position >= Field::maxLength)
+            {
+                valid = false;
+                return;
+            }
+            std::memcpy(Field::data(contact), raw.data() + position, terminator - position);
+            position = terminator + 1; });
+    }
+    return valid && position == raw.size();
+}
+
+// Read the header and block index of a snapshot. Every size is checked against the file and the
+// block layout before anything is allocated from it, so a damaged header is reported, not trusted
+inline bool readSnapshotIndex(std::ifstream &inFile, std::uint64_t &recordCount, std::uint32_t &recordsPerBlock,
+                              std::vector<SnapshotBlock> &blocks)
+{
+    inFile.seekg(0, std::ios::end);
+    std::uint64_t fileSize = static_cast<std::uint64_t>(inFile.tellg());
+    inFile.seekg(0);
+
+    char header[snapshotHeaderSize];
+    if (!inFile || fileSize < snapshotHeaderSize || !inFile.read(header, sizeof(header)) ||
+        std::memcmp(header, snapshotMagic, sizeof(snapshotMagic)) != 0)
+    {
+        return false;
+    }
+    recordsPerBlock = readU32(header + 8);
+    std::uint32_t blockCount = readU32(header + 12);
+    recordCount = readU64(header + 16);
+
+    std::uint64_t dataStart = snapshotHeaderSize + static_cast<std::uint64_t>(blockCount) * snapshotIndexEntrySize + 4;
+    if (recordsPerBlock == 0 || recordsPerBlock > snapshotMaxBlockRecords || dataStart > fileSize)
+    {
+        return false;
+    }
+
+    std::string index(header, sizeof(header));
+    index.resize(dataStart);
+    if (!inFile.read(&index[snapshotHeaderSize], dataStart - snapshotHeaderSize) ||
+        crc32(index.data(), dataStart - 4) != readU32(index.data() + dataStart - 4))
+    {
+        return false;
+    }
+
+    blocks.resize(blockCount);
+    std::uint64_t indexedRecords = 0;
+    for (size_t b = 0; b < blockCount; ++b)
+    {
+        const char *entry = index.data() + snapshotHeaderSize + b * snapshotIndexEntrySize;
+        SnapshotBlock &block = blocks[b];
+        block = SnapshotBlock{readU64(entry), readU32(entry + 8), readU32(entry + 12), readU32(entry + 16), readU32(entry + 20)};
+
+        // Blocks lie inside the file, are full except for the last one, and hold no more bytes than their records can
+        bool last = b + 1 == blockCount;
+        if (block.offset < dataStart || block.offset > fileSize || block.compressedSize > fileSize - block.offset ||
+            block.recordCount == 0 || block.recordCount > recordsPerBlock || (!last && block.recordCount != recordsPerBlock) ||
+            block.rawSize > static_cast<std::uint64_t>(block.recordCount) * sizeof(Contact) ||
+            block.rawSize < static_cast<std::uint64_t>(block.recordCount) * contactFieldCount)
+        {
+            return false;
+        }
+        indexedRecords += block.recordCount;
+    }
+    return indexedRecords == recordCount;
+}
+
+// Read, verify and decode one snapshot block into records (which must have room for its recordCount)
+inline bool readSnapshotBlock(std::ifstream &inFile, const SnapshotBlock &block, Contact *records)
+{
+    std::string compressed(block.compressedSize, '\0');
+    std::string raw;
+    inFile.seekg(static_cast<std::streamoff>(block.offset));
+    return inFile.read(&compressed[0], compressed.size()) &&
+           lzDecompress(compressed.data(), compressed.size(), raw, block.rawSize) &&
+           crc32(raw.data(), raw.size()) == block.checksum &&
+           parseRecords(raw, block.recordCount, records);
+}
+
+// Fetch a single record from a snapshot by decoding only the block that holds it
+inline bool readSnapshotRecord(const char *filename, std::uint64_t recordIndex, Contact &contact)
+{
+    std::ifstream inFile(filename, std::ios::binary | std::ios::in);
+    std::uint64_t recordCount;
+    std::uint32_t recordsPerBlock;
+    std::vector<SnapshotBlock> blocks;
+    if (!inFile || !readSnapshotIndex(inFile, recordCount, recordsPerBlock, blocks) || recordIndex >= recordCount ||
+        recordsPerBlock == 0 || recordIndex / recordsPerBlock >= blocks.size())
+    {
+        return false;
+    }
+
+    const SnapshotBlock &block = blocks[recordIndex / recordsPerBlock];
+    std::vector<Contact> records(block.recordCount);
+    if (!readSnapshotBlock(inFile, block, records.data()) || recordIndex % recordsPerBlock >= records.size())
+    {
+        return false;
+    }
+    contact = records[recordIndex % recordsPerBlock];
+    return true;
+}
+
+// Identifies a contact by shard and slot; stable until the shard is compacted
+struct RecordId
+{
+    std::uint32_t shard;
+    std::uint32_t slot;
+};
+
+// LRU cache of search results (query -> matching record IDs) kept within a memory budget.
+// Every entry remembers the phonebook generation it was computed at; the caller decides
+// whether that is still recent enough for the field the query searched.
+class QueryCache
+{
+private:
+    struct Entry
+    {
+        std::vector<RecordId> ids;
+        std::uint64_t generation;
+        size_t bytes;
+        std::list<std::string>::iterator recency;
+    };
+
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> recency; // Most recently used key first
+    size_t budgetBytes;
+    size_t usedBytes = 0;
+
+    void erase(std::unordered_map<std::string, Entry>::iterator entry)
+    {
+        usedBytes -= entry->second.bytes;
+        recency.erase(entry->second.recency);
+        entries.erase(entry);
+    }
+
+    // Drop least recently used entries until the cache fits its budget
+    void evictToBudget()
+    {
+        while (usedBytes > budgetBytes && !recency.empty())
+        {
+            erase(entries.find(recency.back()));
+            ++evictions;
+        }
+    }
+
+public:
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+
+    explicit QueryCache(size_t budgetBytes) : budgetBytes(budgetBytes)
+    {
+    }
+
+    void setBudget(size_t bytes)
+    {
+        budgetBytes = bytes;
+        evictToBudget();
+    }
+
+    // Cached IDs for a key if they were computed at or after validFrom, otherwise null (a miss)
+    const std::vector<RecordId> *find(const std::string &key, std::uint64_t validFrom)
+    {
+        auto entry = entries.find(key);
+        if (entry == entries.end() || entry->second.generation < validFrom)
+        {
+            if (entry != entries.end())
+            {
+                erase(entry); // Stale: its field changed since
+            }
+            ++misses;
+            return nullptr;
+        }
+
+        recency.splice(recency.begin(), recency, entry->second.recency);
+        ++hits;
+        return &entry->second.ids;
+    }
+
+    void insert(const std::string &key, std::vector<RecordId> ids, std::uint64_t generation)
+    {
+        auto existing = entries.find(key);
+        if (existing != entries.end())
+        {
+            erase(existing);
+        }
+
+        size_t bytes = sizeof(Entry) + 2 * key.size() + ids.size() * sizeof(RecordId);
+        if (bytes > budgetBytes)
+        {
+            return; // Would evict everything else
+        }
+
+        recency.push_front(key);
+        entries.emplace(key, Entry{std::move(ids), generation, bytes, recency.begin()});
+        usedBytes += bytes;
+        evictToBudget();
+    }
+
+    void clear()
+    {
+        entries.clear();
+        recency.clear();
+        usedBytes = 0;
+    }
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+    size_t bytes() const
+    {
+        return usedBytes;
+    }
+};
+
+// Phonebook class to manage contacts
+class Phonebook
+{
+private:
+    // A shard owns one partition of the contacts and the data file it is persisted to
+    struct Shard
+    {
+        ContactList contacts;
+        std::string filename;
+
+        // Staged loading: the files are read in chunks and each chunk becomes searchable once it is in memory.
+        // A shard usually loads its own file, but takes over the files of shards that no longer exist
+        std::vector<std::string> sourceFiles;
+        std::vector<size_t> sourceRecords;
+        size_t expectedRecords = 0;
+        bool unsaved = false; // Rebalanced in memory, but writing its file failed
+        size_t chunkCount = 0;
+        std::unique_ptr<std::atomic<bool>[]> chunkLoaded;
+        std::atomic<bool> visible{false};
+
+        // Slot numbers in name order, built in the background and swapped in atomically (null until built)
+        std::shared_ptr<const std::vector<std::uint32_t>> nameOrder;
+
+        // Soft deletion: slot numbers stay stable until the shard is compacted
+        std::vector<bool> deleted;            // Tombstone bitmap, one bit per slot
+        std::vector<std::uint32_t> freeSlots; // Tombstoned slots that new contacts can reuse
+
+        // Slots filled since the name index unindexedBase was published; listed after the indexed ones
+        std::shared_ptr<const std::vector<std::uint32_t>> unindexedBase;
+        std::vector<std::uint32_t> unindexedSlots;
+        std::vector<bool> unindexed;
+    };
+
+    // Number of records read per chunk during startup
+    static constexpr size_t loadChunkRecords = 65536;
+
+    // Compact a shard once this share of its slots are tombstones
+    static constexpr double compactionRatio = 0.25;
+
+    // Contacts are hash-partitioned by name; a single shard keeps the classic contacts.dat layout
+    std::vector<Shard> shards;
+    std::string dataFile; // Base name the shard file names are derived from
+
+    // Search results cache, invalidated per field: every mutation bumps the generation and
+    // stamps it on the fields it touched, and a cached query is only used if it is newer
+    // than the last change to the field it searched. Deletions are the exception: cached
+    // hits skip tombstoned slots, and the slots only change meaning on reuse or compaction
+    QueryCache queryCache{16 * 1024 * 1024};
+    std::uint64_t generation = 0;
+    std::array<std::uint64_t, contactFieldCount> fieldGeneration{};
+
+    // Background loading and index building; every mutation waits for it to finish first
+    std::thread backgroundWorker;
+    std::atomic<bool> backgroundBusy{false};
+    std::atomic<bool> loadComplete{true};
+    std::atomic<bool> needsRebalance{false};
+    std::vector<std::string> staleFiles; // Loaded files no shard is saved to any more, removed once rebalanced
+    size_t manifestShards = 0;           // Shard count of the files on disk, from the manifest (0: single file)
+    std::atomic<size_t> recordsLoaded{0};
+    size_t recordsExpected = 0;
+
+    // Numbered data file name, e.g. "contacts.dat" -> "contacts.2.dat"
+    static std::string numberedFileName(const std::string &baseName, size_t number)
+    {
+        std::string::size_type dotPosition = baseName.rfind('.');
+        if (dotPosition == std::string::npos)
+        {
+            return baseName + "." + std::to_string(number);
+        }
+        return baseName.substr(0, dotPosition) + "." + std::to_string(number) + baseName.substr(dotPosition);
+    }
+
+    // Build the data file name of a shard; a single shard keeps the base name
+    std::string shardFileName(const std::string &baseName, size_t shardIndex) const
+    {
+        if (shards.size() == 1)
+        {
+            return baseName;
+        }
+        return numberedFileName(baseName, shardIndex);
+    }
+
+    // Name of the manifest that records how many shard files the phonebook was saved to, e.g. "contacts.shards"
+    static std::string manifestFileName(const std::string &baseName)
+    {
+        std::string::size_type dotPosition = baseName.rfind('.');
+        return baseName.substr(0, dotPosition) + ".shards";
+    }
+
+    // Shard count recorded next to baseName, 0 if there is no manifest (a single-file phonebook)
+    static size_t readManifest(const std::string &baseName)
+    {
+        std::ifstream inFile(manifestFileName(baseName));
+        size_t count = 0;
+        if (!(inFile >> count) || count < 2)
+        {
+            return 0;
+        }
+        return count;
+    }
+
+    // Shard count the manifest should record for the current layout
+    size_t layoutShards() const
+    {
+        return shards.size() > 1 ? shards.size() : 0;
+    }
+
+    // The data files a manifest lists, by shard number; only these are ever loaded or retired
+    static std::vector<std::pair<size_t, std::string>> recordedFiles(const std::string &baseName, size_t recordedShards)
+    {
+        std::vector<std::pair<size_t, std::string>> files;
+        if (recordedShards == 0)
+        {
+            files.emplace_back(0, baseName);
+        }
+        for (size_t k = 0; k < recordedShards; ++k)
+        {
+            files.emplace_back(k, numberedFileName(baseName, k));
+        }
+        return files;
+    }
+
+    // Record the current shard count next to the data files; a single shard needs no manifest
+    bool writeManifest()
+    {
+        std::string manifest = manifestFileName(dataFile);
+        if (layoutShards() == 0)
+        {
+            std::remove(manifest.c_str());
+            manifestShards = 0;
+            return true;
+        }
+
+        std::ofstream outFile(manifest, std::ios::out);
+        outFile << shards.size() << std::endl;
+        outFile.close();
+        if (!outFile)
+        {
+            std::cerr << "Error writing " << manifest << "." << std::endl;
+            return false;
+        }
+        manifestShards = shards.size();
+        return true;
+    }
+
+    // Map a name to the shard that owns it (FNV-1a over the lowercase name, stable across runs)
+    size_t shardIndexFor(const char *name) const
+    {
+        std::uint32_t hash = 2166136261u;
+        for (const char *c = name; *c != '\0'; ++c)
+        {
+            hash ^= static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(*c)));
+            hash *= 16777619u;
+        }
+        return hash % shards.size();
+    }
+
+    // Run fn(shardIndex) for every shard, one thread per shard when there is more than one
+    template <typename Fn>
+    void forEachShard(Fn fn) const
+    {
+        if (shards.size() == 1)
+        {
+            fn(0);
+            return;
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(shards.size());
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            workers.emplace_back(fn, i);
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    // Record a mutation of the given fields (a bitmask of field ids)
+    void touchFields(unsigned fieldMask)
+    {
+        ++generation;
+        for (unsigned field = 0; field < contactFieldCount; ++field)
+        {
+            if (fieldMask & (1u << field))
+            {
+                fieldGeneration[field] = generation;
+            }
+        }
+    }
+
+    // Total number of contacts across all shards
+    size_t contactCount() const
+    {
+        if (!loadComplete.load(std::memory_order_acquire))
+        {
+            return recordsExpected;
+        }
+
+        size_t count = 0;
+        for (const Shard &shard : shards)
+        {
+            count += shard.contacts.size() - shard.freeSlots.size();
+        }
+        return count;
+    }
+
+    // Number of whole records in a data file, returns false if the file could not be opened
+    bool recordCountOf(const std::string &filename, size_t &count) const
+    {
+        std::ifstream inFile(filename, std::ios::binary | std::ios::in | std::ios::ate);
+        if (!inFile)
+        {
+            return false;
+        }
+
+        count = static_cast<size_t>(inFile.tellg()) / sizeof(Contact);
+        return true;
+    }
+
+    // Whether a chunk of a shard is in memory (slots added after startup are always loaded)
+    bool chunkReady(const Shard &shard, size_t chunk) const
+    {
+        return chunk >= shard.chunkCount || shard.chunkLoaded[chunk].load(std::memory_order_acquire);
+    }
+
+    // Read one shard's file with several threads, publishing every chunk as soon as it is read
+    void loadShardChunks(size_t shardIndex, size_t threadCount)
+    {
+        Shard &shard = shards[shardIndex];
+        shard.contacts.resize(shard.expectedRecords);
+        shard.chunkCount = (shard.expectedRecords + loadChunkRecords - 1) / loadChunkRecords;
+        shard.chunkLoaded.reset(new std::atomic<bool>[shard.chunkCount]);
+        for (size_t chunk = 0; chunk < shard.chunkCount; ++chunk)
+        {
+            shard.chunkLoaded[chunk].store(false, std::memory_order_relaxed);
+        }
+        shard.visible.store(true, std::memory_order_release);
+
+        std::atomic<size_t> nextChunk{0};
+        auto readChunks = [this, &shard, &nextChunk]()
+        {
+            std::vector<std::ifstream> inFiles(shard.sourceFiles.size());
+            size_t chunk;
+            while ((chunk = nextChunk++) < shard.chunkCount)
+            {
+                size_t first = chunk * loadChunkRecords;
+                size_t count = std::min(loadChunkRecords, shard.expectedRecords - first);
+
+                // The source files are laid out one after another in the shard's slots
+                size_t fileFirst = 0;
+                for (size_t f = 0; f < shard.sourceFiles.size(); ++f)
+                {
+                    size_t fileEnd = fileFirst + shard.sourceRecords[f];
+                    size_t from = std::max(first, fileFirst);
+                    size_t to = std::min(first + count, fileEnd);
+                    if (from < to)
+                    {
+                        if (!inFiles[f].is_open())
+                        {
+                            inFiles[f].open(shard.sourceFiles[f], std::ios::binary | std::ios::in);
+                        }
+                        inFiles[f].seekg(static_cast<std::streamoff>((from - fileFirst) * sizeof(Contact)));
+                        char *destination = reinterpret_cast<char *>(&shard.contacts[from]);
+                        inFiles[f].read(destination, (to - from) * sizeof(Contact));
+
+                        // The slots are uninitialized: whatever a short file did not fill becomes a tombstone
+                        size_t filled = static_cast<size_t>(inFiles[f].gcount());
+                        std::memset(destination + filled, 0, (to - from) * sizeof(Contact) - filled);
+                        inFiles[f].clear();
+                    }
+                    fileFirst = fileEnd;
+                }
+
+                // Never trust a field read from disk to be terminated inside its buffer
+                for (size_t slot = first; slot < first + count; ++slot)
+                {
+                    Contact &contact = shard.contacts[slot];
+                    forEachField([&contact](auto field)
+                                 { decltype(field)::data(contact)[decltype(field)::maxLength - 1] = '\0'; });
+                }
+
+                shard.chunkLoaded[chunk].store(true, std::memory_order_release);
+                recordsLoaded += count;
+            }
+        };
+
+        std::vector<std::thread> readers;
+        for (size_t i = 1; i < threadCount && i < shard.chunkCount; ++i)
+        {
+            readers.emplace_back(readChunks);
+        }
+        readChunks();
+        for (std::thread &reader : readers)
+        {
+            reader.join();
+        }
+    }
+
+    // Current name index of a shard, or null if it has not been built
+    std::shared_ptr<const std::vector<std::uint32_t>> nameIndex(size_t shardIndex) const
+    {
+        return std::atomic_load(&shards[shardIndex].nameOrder);
+    }
+
+    // Swap in a new name index for a shard
+    void setNameIndex(size_t shardIndex, std::shared_ptr<const std::vector<std::uint32_t>> order)
+    {
+        std::atomic_store(&shards[shardIndex].nameOrder, std::move(order));
+    }
+
+    // Sort the slot numbers of one shard by name off to the side, then publish them in one swap
+    void buildNameIndex(size_t shardIndex)
+    {
+        const Shard &shard = shards[shardIndex];
+        const ContactList &contacts = shard.contacts;
+        std::shared_ptr<std::vector<std::uint32_t>> order = std::make_shared<std::vector<std::uint32_t>>();
+        order->reserve(contacts.size() - shard.freeSlots.size());
+        for (size_t slot = 0; slot < contacts.size(); ++slot)
+        {
+            if (!shard.deleted[slot])
+            {
+                order->push_back(static_cast<std::uint32_t>(slot));
+            }
+        }
+        FieldLess<NameField> less;
+        std::stable_sort(order->begin(), order->end(), [&contacts, &less](std::uint32_t a, std::uint32_t b)
+                         { return less(contacts[a], contacts[b]); });
+        setNameIndex(shardIndex, order);
+    }
+
+    // Deleted slots are stored zeroed on disk, so a record with no name and no phone is a tombstone
+    static bool isTombstone(const Contact &contact)
+    {
+        return contact.name[0] == '\0' && contact.phoneNo[0] == '\0';
+    }
+
+    // Rebuild the tombstone bitmap and free list of a shard that was just read from disk
+    void markTombstones(size_t shardIndex)
+    {
+        Shard &shard = shards[shardIndex];
+        shard.deleted.assign(shard.contacts.size(), false);
+        shard.freeSlots.clear();
+        for (size_t slot = 0; slot < shard.contacts.size(); ++slot)
+        {
+            if (isTombstone(shard.contacts[slot]))
+            {
+                shard.deleted[slot] = true;
+                shard.freeSlots.push_back(static_cast<std::uint32_t>(slot));
+            }
+        }
+    }
+
+    // Forget the slots filled before the current name index was published, it already holds them
+    void syncUnindexed(size_t shardIndex)
+    {
+        Shard &shard = shards[shardIndex];
+        std::shared_ptr<const std::vector<std::uint32_t>> order = nameIndex(shardIndex);
+        if (shard.unindexedBase != order)
+        {
+            shard.unindexedSlots.clear();
+            shard.unindexed.clear();
+            shard.unindexedBase = order;
+        }
+    }
+
+    // List a slot after the indexed ones until the next sort, because its name is not where the index has it
+    void markUnindexed(size_t shardIndex, size_t slot)
+    {
+        Shard &shard = shards[shardIndex];
+        syncUnindexed(shardIndex);
+        shard.unindexed.resize(shard.contacts.size(), false);
+        if (!shard.unindexed[slot])
+        {
+            shard.unindexed[slot] = true;
+            shard.unindexedSlots.push_back(static_cast<std::uint32_t>(slot));
+        }
+    }
+
+    // Put a contact into a free slot of a shard (or a new one at the end) and return the slot
+    size_t insertContact(size_t shardIndex, const Contact &contact)
+    {
+        Shard &shard = shards[shardIndex];
+        size_t slot = shard.contacts.size();
+        if (shard.freeSlots.empty())
+        {
+            shard.contacts.push_back(contact);
+            shard.deleted.push_back(false);
+        }
+        else
+        {
+            slot = shard.freeSlots.back();
+            shard.freeSlots.pop_back();
+            shard.contacts[slot] = contact;
+            shard.deleted[slot] = false;
+        }
+
+        markUnindexed(shardIndex, slot);
+        touchFields(allContactFields);
+        return slot;
+    }
+
+    // Turn a slot into a tombstone; it stays in place until the shard is compacted
+    void tombstoneSlot(size_t shardIndex, size_t slot)
+    {
+        Shard &shard = shards[shardIndex];
+        std::memset(static_cast<void *>(&shard.contacts[slot]), 0, sizeof(Contact));
+        shard.deleted[slot] = true;
+        shard.freeSlots.push_back(static_cast<std::uint32_t>(slot));
+    }
+
+    // Drop the tombstones of a shard, renumber its name index to match and rewrite its file;
+    // returns false if the file could not be written
+    bool compactShard(size_t shardIndex)
+    {
+        Shard &shard = shards[shardIndex];
+        syncUnindexed(shardIndex);
+
+        // Slide the live contacts down, remembering where every slot went
+        std::vector<std::uint32_t> renumbered(shard.contacts.size());
+        size_t next = 0;
+        for (size_t slot = 0; slot < shard.contacts.size(); ++slot)
+        {
+            renumbered[slot] = static_cast<std::uint32_t>(next);
+            if (!shard.deleted[slot])
+            {
+                shard.contacts[next++] = shard.contacts[slot];
+            }
+        }
+        shard.contacts.resize(next);
+
+        // Keep the index order, dropping tombstones and slots that are listed as unindexed
+        std::shared_ptr<const std::vector<std::uint32_t>> order = nameIndex(shardIndex);
+        if (order)
+        {
+            std::shared_ptr<std::vector<std::uint32_t>> updated = std::make_shared<std::vector<std::uint32_t>>();
+            updated->reserve(next);
+            for (std::uint32_t slot : *order)
+            {
+                bool listedSeparately = slot < shard.unindexed.size() && shard.unindexed[slot];
+                if (!shard.deleted[slot] && !listedSeparately)
+                {
+                    updated->push_back(renumbered[slot]);
+                }
+            }
+            setNameIndex(shardIndex, updated);
+        }
+
+        std::vector<std::uint32_t> unindexedSlots;
+        for (std::uint32_t slot : shard.unindexedSlots)
+        {
+            if (!shard.deleted[slot])
+            {
+                unindexedSlots.push_back(renumbered[slot]);
+            }
+        }
+        shard.unindexedSlots = unindexedSlots;
+        shard.unindexed.assign(next, false);
+        for (std::uint32_t slot : shard.unindexedSlots)
+        {
+            shard.unindexed[slot] = true;
+        }
+        shard.unindexedBase = nameIndex(shardIndex);
+
+        shard.deleted.assign(next, false);
+        shard.freeSlots.clear();
+        bool saved = saveShard(shardIndex);
+
+        // Slot numbers changed, so cached record IDs are no longer valid
+        touchFields(allContactFields);
+        return saved;
+    }
+
+    // Compact a shard once enough of it is tombstones
+    void compactIfNeeded(size_t shardIndex)
+    {
+        const Shard &shard = shards[shardIndex];
+        if (shard.freeSlots.size() > shard.contacts.size() * compactionRatio)
+        {
+            compactShard(shardIndex);
+        }
+    }
+
+    // Whether a shard holds contacts that hash to another shard (e.g. after changing the shard count)
+    bool hasMisplacedContacts(size_t shardIndex) const
+    {
+        const Shard &shard = shards[shardIndex];
+        for (size_t slot = 0; slot < shard.contacts.size(); ++slot)
+        {
+            if (!shard.deleted[slot] && shardIndexFor(shard.contacts[slot].name) != shardIndex)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Run work on the background thread; backgroundBusy stays set until it returns
+    template <typename Fn>
+    void startBackgroundWork(Fn work)
+    {
+        backgroundBusy = true;
+        backgroundWorker = std::thread([this, work]()
+                                       {
+            work();
+            backgroundBusy = false; });
+    }
+
+    // Block until background loading and indexing are done
+    void waitForBackgroundWork()
+    {
+        if (backgroundWorker.joinable())
+        {
+            backgroundWorker.join();
+        }
+    }
+
+    // Before changing any contact: finish background work and persist a pending rebalance (or a new
+    // shard count), so the files are only rewritten by runs that modify the phonebook
+    void prepareForMutation()
+    {
+        waitForBackgroundWork();
+
+        if (needsRebalance.exchange(false))
+        {
+            rebalanceShards();
+        }
+    }
+
+    // Remove the files whose contacts now live in other shard files
+    void retireStaleFiles()
+    {
+        for (const std::string &file : staleFiles)
+        {
+            if (std::remove(file.c_str()) != 0)
+            {
+                std::cerr << "Error removing old shard file " << file << "." << std::endl;
+            }
+        }
+        staleFiles.clear();
+    }
+
+    // Write one shard back to its own data file, returns false if it could not be written completely
+    bool saveShard(size_t shardIndex)
+    {
+        std::ofstream outFile(shards[shardIndex].filename, std::ios::binary | std::ios::out);
+        if (!outFile)
+        {
+            std::cerr << "Error opening file for writing." << std::endl;
+            return false;
+        }
+
+        for (const Contact &contact : shards[shardIndex].contacts)
+        {
+            outFile.write(reinterpret_cast<const char *>(&contact), sizeof(Contact));
+        }
+
+        outFile.close();
+        if (!outFile)
+        {
+            std::cerr << "Error writing " << shards[shardIndex].filename << "." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    // Write a single slot in place, so an edit costs one record of I/O instead of a full rewrite
+    void saveSlot(size_t shardIndex, size_t slot)
+    {
+        std::fstream file(shards[shardIndex].filename, std::ios::binary | std::ios::in | std::ios::out);
+        if (!file)
+        {
+            saveShard(shardIndex); // No file yet
+            return;
+        }
+
+        file.seekp(static_cast<std::streamoff>(slot * sizeof(Contact)));
+        file.write(reinterpret_cast<const char *>(&shards[shardIndex].contacts[slot]), sizeof(Contact));
+        file.close();
+    }
+
+    // Move contacts that live in the wrong shard (e.g. after changing the shard count), save what changed
+    // and retire the files of shards that no longer exist
+    void rebalanceShards()
+    {
+        // Shards that took over another file's contacts have to be rewritten even if nothing moves, and
+        // so does every shard when the manifest lists another layout
+        bool newLayout = manifestShards != layoutShards();
+        std::vector<bool> dirty(shards.size(), false);
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            const Shard &shard = shards[i];
+            dirty[i] = newLayout || shard.unsaved || shard.sourceFiles.size() > 1 ||
+                       (shard.sourceFiles.size() == 1 && shard.sourceFiles[0] != shard.filename);
+        }
+
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            Shard &shard = shards[i];
+            for (size_t slot = 0; slot < shard.contacts.size(); ++slot)
+            {
+                size_t target = shardIndexFor(shard.contacts[slot].name);
+                if (!shard.deleted[slot] && target != i)
+                {
+                    shards[target].contacts.push_back(shard.contacts[slot]);
+                    shards[target].deleted.push_back(false);
+                    tombstoneSlot(i, slot);
+                    dirty[target] = true;
+                    dirty[i] = true;
+                }
+            }
+        }
+
+        bool allSaved = true;
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            if (dirty[i])
+            {
+                shards[i].unsaved = !compactShard(i);
+                allSaved = allSaved && !shards[i].unsaved;
+                buildNameIndex(i);
+                syncUnindexed(i);
+            }
+        }
+
+        // The old files are the only complete copy until every new one is written and the manifest
+        // points at them; try again on the next change
+        if (!allSaved || !writeManifest())
+        {
+            std::cerr << "Old shard files were kept because the new ones could not be written." << std::endl;
+            needsRebalance = true;
+            return;
+        }
+
+        for (Shard &shard : shards)
+        {
+            shard.sourceFiles.clear();
+            shard.sourceRecords.clear();
+        }
+        retireStaleFiles();
+    }
+
+    // Contact stored under a record ID
+    const Contact &contactAt(RecordId id) const
+    {
+        return shards[id.shard].contacts[id.slot];
+    }
+
+    // Scatter a predicate over all shards and gather the IDs of the matching contacts
+    template <typename Predicate>
+    std::vector<RecordId> collectMatches(Predicate matches) const
+    {
+        std::vector<std::vector<RecordId>> partials(shards.size());
+        std::vector<char> ordered(shards.size(), false);
+        bool loaded = loadComplete.load(std::memory_order_acquire);
+        forEachShard([this, &partials, &ordered, &matches, loaded](size_t i)
+                     {
+            const Shard &shard = shards[i];
+            if (!shard.visible.load(std::memory_order_acquire))
+            {
+                return; // Not even sized yet, nothing to scan
+            }
+
+            const ContactList &contacts = shard.contacts;
+            std::shared_ptr<const std::vector<std::uint32_t>> order = nameIndex(i);
+            if (order)
+            {
+                // Indexed slots in name order, merged with the slots added or renamed since the index was built
+                bool listUnindexed = shard.unindexedBase == order;
+                for (std::uint32_t slot : *order)
+                {
+                    bool listedSeparately = listUnindexed && slot < shard.unindexed.size() && shard.unindexed[slot];
+                    if (!shard.deleted[slot] && !listedSeparately && matches(contacts[slot]))
+                    {
+                        partials[i].push_back(RecordId{static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(slot)});
+                    }
+                }
+                if (listUnindexed)
+                {
+                    std::vector<std::uint32_t> delta;
+                    for (std::uint32_t slot : shard.unindexedSlots)
+                    {
+                        if (!shard.deleted[slot] && matches(contacts[slot]))
+                        {
+                            delta.push_back(slot);
+                        }
+                    }
+                    std::stable_sort(delta.begin(), delta.end(), [&contacts](std::uint32_t a, std::uint32_t b)
+                              { return FieldLess<NameField>()(contacts[a], contacts[b]); });
+
+                    size_t middle = partials[i].size();
+                    for (std::uint32_t slot : delta)
+                    {
+                        partials[i].push_back(RecordId{static_cast<std::uint32_t>(i), slot});
+                    }
+                    std::inplace_merge(partials[i].begin(), partials[i].begin() + middle, partials[i].end(),
+                                       [&contacts](RecordId a, RecordId b)
+                                       { return FieldLess<NameField>()(contacts[a.slot], contacts[b.slot]); });
+                }
+                ordered[i] = true;
+                return;
+            }
+
+            // Fallback scan in slot order, skipping chunks that are still being read; the tombstone
+            // bitmap is only filled in once the whole shard is loaded, so check the records until then
+            size_t slot = 0;
+            while (slot < contacts.size())
+            {
+                if (slot % loadChunkRecords == 0 && !chunkReady(shard, slot / loadChunkRecords))
+                {
+                    slot += loadChunkRecords;
+                    continue;
+                }
+                bool live = loaded ? !shard.deleted[slot] : !isTombstone(contacts[slot]);
+                if (live && matches(contacts[slot]))
+                {
+                    partials[i].push_back(RecordId{static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(slot)});
+                }
+                ++slot;
+            } });
+
+        // Concatenate the per-shard results, merging them by name when every shard is indexed
+        bool mergeByName = std::find(ordered.begin(), ordered.end(), false) == ordered.end();
+        std::vector<RecordId> results;
+        for (const std::vector<RecordId> &partial : partials)
+        {
+            size_t middle = results.size();
+            results.insert(results.end(), partial.begin(), partial.end());
+            if (mergeByName)
+            {
+                std::inplace_merge(results.begin(), results.begin() + middle, results.end(),
+                                   [this](RecordId a, RecordId b)
+                                   { return FieldLess<NameField>()(contactAt(a), contactAt(b)); });
+            }
+        }
+        return results;
+    }
+
+    // Tell the user that results only cover the contacts loaded so far
+    void printLoadingNotice() const
+    {
+        if (!loadComplete.load(std::memory_order_acquire))
+        {
+            std::cout << "\n(Still loading: results cover " << recordsLoaded.load() << " of "
+                      << recordsExpected << " contacts.)" << std::endl;
+        }
+    }
+
+    // Print every field of a contact on its own line
+    void printFields(const Contact &contact) const
+    {
+        forEachField([&contact](auto field)
+                     { std::cout << decltype(field)::label << ": " << decltype(field)::data(contact) << std::endl; });
+    }
+
+    // Print a single contact record
+    void printContact(const Contact &contact) const
+    {
+        std::cout << "-----------------------------------" << std::endl;
+        printFields(contact);
+        std::cout << "-----------------------------------" << std::endl;
+    }
+
+    // Search one field and print the matches; the matcher is instantiated per field
+    template <typename Field>
+    void searchBy(const std::string &query, const char *title, const char *notFoundMessage)
+    {
+        if (contactCount() == 0)
+        {
+            std::cout << "Phonebook is empty. No contacts to search." << std::endl;
+            return;
+        }
+
+        std::cout << "\nSearch Results by " << title << ": " << query << std::endl;
+
+        // Repeated queries are answered from the cache unless the searched field changed since
+        std::string folded = foldQuery<Field>(query);
+        std::string cacheKey = std::to_string(Field::id) + ":" + folded;
+        const std::vector<RecordId> *cached = queryCache.find(cacheKey, fieldGeneration[Field::id]);
+
+        std::vector<RecordId> results;
+        if (cached)
+        {
+            for (RecordId id : *cached)
+            {
+                if (!shards[id.shard].deleted[id.slot])
+                {
+                    results.push_back(id);
+                }
+            }
+        }
+        else
+        {
+            // Partial results (still loading) and results in a soon to be replaced order are not kept. Decide
+            // before scanning: loading may finish during the scan, after chunks were already skipped
+            bool cacheable = !backgroundBusy;
+
+            // Check if the field contains the partial query (case-insensitive where the field folds case)
+            results = collectMatches([&folded](const Contact &contact)
+                                     { return fieldContains<Field>(contact, folded); });
+
+            if (cacheable)
+            {
+                queryCache.insert(cacheKey, results, generation);
+            }
+        }
+
+        for (RecordId id : results)
+        {
+            printContact(contactAt(id));
+        }
+        if (results.empty())
+        {
+            std::cout << notFoundMessage << std::endl;
+        }
+        printLoadingNotice();
+    }
+
+    // Vector to store predefined custom groups
+    std::vector<std::string> customGroups{"Family", "Friend", "Work", "Other"};
+
+    // Prompt for a field until the input passes the field's validator
+    template <typename Field>
+    void readField(Contact &contact, const char *prompt)
+    {
+        char *value = Field::data(contact);
+        bool valid = false;
+        do
+        {
+            std::cout << prompt;
+            std::cin.getline(value, Field::maxLength);
+
+            valid = Field::validate(value);
+            Field::normalize(value);
+
+            if (!valid)
+            {
+                std::cout << Field::invalidMessage() << std::endl;
+            }
+        } while (!valid);
+    }
+
+    // Let the user pick a group, or add their own, for a contact
+    void readGroup(Contact &contact)
+    {
+        int groupChoice = getGroupChoice();
+        if (groupChoice == customGroups.size() + 1)
+        {
+            // User wants to add their own group
+            std::cout << "Enter your own group: ";
+            std::cin.getline(contact.group, sizeof(contact.group));
+            customGroups.push_back(contact.group);
+        }
+        else
+        {
+            // Predefined or custom groups
+            std::strcpy(contact.group, customGroups[groupChoice - 1].c_str());
+        }
+    }
+
+    // Method to display group options and get user's choice
+    int getGroupChoice()
+    {
+        std::cout << "Select a group:" << std::endl;
+        for (size_t i = 0; i < customGroups.size(); ++i)
+        {
+            std::cout << i + 1 << ". " << customGroups[i] << std::endl;
+        }
+        std::cout << customGroups.size() + 1 << ". Add your own group" << std::endl;
+
+        int choice = 0;
+
+        while (choice < 1 || choice > customGroups.size() + 1)
+        {
+            std::cout << "Enter your choice: ";
+            char choiceChar;
+            std::cin >> choiceChar;
+            clearInputBuffer();
+
+            choice = choiceChar - '0';
+
+            if (choice < 1 || choice > customGroups.size() + 1)
+            {
+                std::cout << "Invalid choice. Please enter a valid option." << std::endl;
+            }
+        }
+
+        return choice;
+    }
+
+public:
+    // Create a phonebook whose contacts are partitioned across shardCount data files
+    explicit Phonebook(size_t shardCount = 1, const char *filename = "contacts.dat")
+        : shards(shardCount == 0 ? 1 : shardCount), dataFile(filename), manifestShards(readManifest(filename))
+    {
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            shards[i].filename = shardFileName(filename, i);
+        }
+        needsRebalance = manifestShards != layoutShards();
+    }
+
+    // Let background loading finish before the phonebook goes away; nothing is written on the way out
+    ~Phonebook()
+    {
+        waitForBackgroundWork();
+    }
+
+    // Start loading contacts in the background; searches see each chunk as soon as it is read
+    void startLoading(const char *filename)
+    {
+        waitForBackgroundWork();
+
+        recordsExpected = 0;
+        recordsLoaded = 0;
+        needsRebalance = false;
+        staleFiles.clear();
+        dataFile = filename;
+        manifestShards = readManifest(filename);
+        queryCache.clear();
+        touchFields(allContactFields);
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            Shard &shard = shards[i];
+            shard.contacts.clear(); // Clear the shard before loading data
+            shard.deleted.clear();
+            shard.freeSlots.clear();
+            shard.unindexedSlots.clear();
+            shard.unindexed.clear();
+            shard.unindexedBase = nullptr;
+            shard.visible = false;
+            setNameIndex(i, nullptr);
+            shard.filename = shardFileName(filename, i);
+            shard.sourceFiles.clear();
+            shard.sourceRecords.clear();
+            shard.expectedRecords = 0;
+            shard.unsaved = false;
+        }
+
+        // Load the files the manifest lists. File K goes into shard K % N, so files of shards that no
+        // longer exist (or a single contacts.dat) are picked up and rebalanced on the first change
+        std::vector<std::pair<size_t, std::string>> sources = recordedFiles(filename, manifestShards);
+
+        bool opened = false;
+        for (const auto &source : sources)
+        {
+            size_t count = 0;
+            if (!recordCountOf(source.second, count))
+            {
+                continue;
+            }
+
+            Shard &shard = shards[source.first % shards.size()];
+            shard.sourceFiles.push_back(source.second);
+            shard.sourceRecords.push_back(count);
+            shard.expectedRecords += count;
+            recordsExpected += count;
+            opened = true;
+            if (source.second != shard.filename)
+            {
+                staleFiles.push_back(source.second);
+            }
+        }
+
+        if (!opened)
+        {
+            std::cerr << "Error opening file for reading." << std::endl;
+        }
+        needsRebalance = !staleFiles.empty() || manifestShards != layoutShards();
+
+        // Each shard is read by its share of the cores and indexed by name as soon as it is in memory
+        loadComplete = false;
+        startBackgroundWork([this]()
+                            {
+            size_t threadsPerShard = std::max<size_t>(1, std::thread::hardware_concurrency() / shards.size());
+            forEachShard([this, threadsPerShard](size_t i)
+                         {
+                loadShardChunks(i, threadsPerShard);
+                markTombstones(i);
+                if (shards.size() > 1 && hasMisplacedContacts(i))
+                {
+                    needsRebalance = true;
+                }
+                buildNameIndex(i); });
+            loadComplete.store(true, std::memory_order_release); });
+    }
+
+    // Limit the memory used by cached search results
+    void setQueryCacheBudget(size_t bytes)
+    {
+        queryCache.setBudget(bytes);
+    }
+
+    // Hit/miss statistics of the search results cache
+    const QueryCache &queryCacheStats() const
+    {
+        return queryCache;
+    }
+
+    // Method to load contacts from a binary file and wait until they are all in memory
+    void loadFromFile(const char *filename)
+    {
+        startLoading(filename);
+        waitForBackgroundWork();
+    }
+
+    // Show startup progress while contacts are being loaded or indexed in the background, and query cache statistics
+    void printStatus() const
+    {
+        if (queryCache.hits + queryCache.misses > 0)
+        {
+            std::cout << "\t\t\t\tQuery cache: " << queryCache.hits << " hits, " << queryCache.misses << " misses, "
+                      << queryCache.size() << " cached queries (" << (queryCache.bytes() + 1023) / 1024 << " KB)\n\n";
+        }
+
+        if (!backgroundBusy)
+        {
+            return;
+        }
+
+        size_t indexed = 0;
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            indexed += nameIndex(i) ? 1 : 0;
+        }
+
+        size_t loaded = recordsLoaded;
+        std::cout << "\t\t\t\tLoaded " << loaded << " of " << recordsExpected << " contacts";
+        if (recordsExpected > 0)
+        {
+            std::cout << " (" << loaded * 100 / recordsExpected << "%)";
+        }
+        std::cout << ", name index ready for " << indexed << " of " << shards.size() << " shards\n\n";
+    }
+
+    // Add a contact to the shard that owns its name
+    void addContact(const Contact &contact)
+    {
+        prepareForMutation();
+        insertContact(shardIndexFor(contact.name), contact);
+    }
+
+    // Save contacts to binary files, one per shard
+    void saveToFile(const char *filename)
+    {
+        prepareForMutation();
+        dataFile = filename;
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            shards[i].filename = shardFileName(filename, i);
+        }
+        forEachShard([this](size_t i)
+                     { saveShard(i); });
+        writeManifest();
+    }
+
+    // Function to add a new contact through user input
+    void addContactFromUserInput()
+    {
+        prepareForMutation();
+
+        Contact newContact;
+
+        std::cout << "\n.......CREATE NEW PHONE RECORD.........\n";
+        fflush(stdin); // clears the input buffers like '\n'
+        readField<NameField>(newContact, "Name: ");
+
+        // Input validation for Phone Number and Email
+        readField<PhoneField>(newContact, "Phone: ");
+        readField<EmailField>(newContact, "Email (Enter 'NA' to leave empty): ");
+
+        // Get the group choice from the user
+        readGroup(newContact);
+
+        // Add the new contact to the phonebook, reusing a deleted slot if there is one
+        size_t shardIndex = shardIndexFor(newContact.name);
+        size_t slot = insertContact(shardIndex, newContact);
+
+        // Save just the slot that received the new contact
+        saveSlot(shardIndex, slot);
+    }
+
+    // Print all contacts
+    void printContacts()
+    {
+        if (contactCount() == 0)
+        {
+            std::cout << "\nPhonebook is empty." << std::endl;
+            return;
+        }
+
+        // std::cout << "\n...............PHONE BOOK RECORD...............\n";
+        std::cout << "\n\n\t\t\t\t--------------------------------------------------- \n";
+        std::cout << "\t\t\t\t\t   >>> PHONE BOOK RECORD <<< \n";
+        std::cout << "\t\t\t\t--------------------------------------------------- \n\n";
+        for (RecordId id : collectMatches([](const Contact &)
+                                          { return true; }))
+        {
+            std::cout << "\n";
+            printContact(contactAt(id));
+        }
+        printLoadingNotice();
+    }
+
+    // Modify the searchByName function
+    void searchByName(const std::string &name)
+    {
+        searchBy<NameField>(name, "Name", "No contacts found with the given name.");
+    }
+
+    // Method to search contacts by a part of the phone number
+    void searchByPhoneNumber(const std::string &partialPhoneNo)
+    {
+        searchBy<PhoneField>(partialPhoneNo, "Phone Number", "No contacts found with the given partial phone number.");
+    }
+
+    // Modify the searchByGroup function
+    void searchByGroup(const std::string &group)
+    {
+        searchBy<GroupField>(group, "Group", "No contacts found in the given group.");
+    }
+
+    // Method to modify a contact's information
+    void modifyContact(const std::string &name)
+    {
+        prepareForMutation();
+
+        if (contactCount() == 0)
+        {
+            std::cout << "Phonebook is empty. Cannot modify contact." << std::endl;
+            return;
+        }
+
+        bool found = false;
+
+        // Only the shard that owns the name can hold the contact
+        size_t shardIndex = shardIndexFor(name.c_str());
+        ContactList &contacts = shards[shardIndex].contacts;
+
+        // Iterate through the contacts to find the contact to be modified
+        for (size_t i = 0; i < contacts.size(); ++i)
+        {
+            Contact &contact = contacts[i];
+            // Case-insensitive comparison for exact name match, skipping deleted slots
+            if (!shards[shardIndex].deleted[i] && fieldEquals<NameField>(contact, name))
+            {
+                found = true;
+
+                // Display the current contact information
+                std::cout << "Current Contact Information:" << std::endl;
+                printFields(contact);
+
+                // Remember the contact as it was, to invalidate only searches on the fields that change
+                Contact before = contact;
+
+                // Prompt the user for modification choice
+                char modifyChoice;
+                std::cout << "\nDo you want to modify the entire contact? (y/n): ";
+                std::cin >> modifyChoice;
+
+                clearInputBuffer(); // Clear input buffer after reading choice
+
+                if (modifyChoice == 'y' || modifyChoice == 'Y')
+                {
+                    // Modify the entire contact
+                    std::cout << "Enter new information for the contact:" << std::endl;
+                    readField<NameField>(contact, "Name: ");
+                    readField<PhoneField>(contact, "Enter new phone number: ");
+                    readField<EmailField>(contact, "Enter new email: ");
+                    readGroup(contact);
+                }
+                else
+                {
+                    // Modify specific parts of the contact
+                    std::cout << "Choose the part you want to modify:" << std::endl;
+                    std::cout << "1. Name" << std::endl;
+                    std::cout << "2. Phone" << std::endl;
+                    std::cout << "3. Email" << std::endl;
+                    std::cout << "4. Group" << std::endl;
+                    std::cout << "Enter your choice: ";
+                    char partChoice;
+                    std::cin >> partChoice;
+                    clearInputBuffer();
+
+                    switch (partChoice)
+                    {
+                    case '1':
+                        readField<NameField>(contact, "Enter new name: ");
+                        break;
+                    case '2':
+                        readField<PhoneField>(contact, "Enter new phone number: ");
+                        break;
+                    case '3':
+                        readField<EmailField>(contact, "Enter new email: ");
+                        break;
+                    case '4':
+                        readGroup(contact);
+                        break;
+                    default:
+                        std::cout << "Invalid choice. Contact not modified." << std::endl;
+                        break;
+                    }
+                }
+
+                // Every cached result is in name order, so a rename invalidates them all
+                bool renamed = std::strcmp(before.name, contact.name) != 0;
+                touchFields(renamed ? allContactFields : changedFields(before, contact));
+
+                // A renamed contact may belong to another shard now, or at least to another place in its order
+                size_t targetShard = shardIndexFor(contact.name);
+                if (targetShard != shardIndex)
+                {
+                    saveSlot(targetShard, insertContact(targetShard, contact));
+                    tombstoneSlot(shardIndex, i);
+                }
+                else if (renamed)
+                {
+                    markUnindexed(shardIndex, i);
+                }
+
+                // Save the modified slot to file
+                saveSlot(shardIndex, i);
+                compactIfNeeded(shardIndex);
+
+                std::cout << "\nContact information has been modified." << std::endl;
+                break; // Exit the loop once the contact is modified
+            }
+        }
+
+        if (!found)
+        {
+            std::cout << "\nNo contact found with the given name." << std::endl;
+        }
+    }
+
+    // Method to delete a contact by name
+    void deleteContact(const std::string &name)
+    {
+        prepareForMutation();
+
+        // Check if the phonebook is already empty
+        if (contactCount() == 0)
+        {
+            std::cout << "\nPhonebook is already empty. No contacts to delete." << std::endl;
+            return;
+        }
+
+        // Only the shard that owns the name can hold the contact
+        size_t shardIndex = shardIndexFor(name.c_str());
+        ContactList &contacts = shards[shardIndex].contacts;
+
+        // Tombstone every matching contact in place; only those slots are written back
+        size_t deletedCount = 0;
+        for (size_t i = 0; i < contacts.size(); ++i)
+        {
+            if (!shards[shardIndex].deleted[i] && fieldEquals<NameField>(contacts[i], name))
+            {
+                tombstoneSlot(shardIndex, i);
+                saveSlot(shardIndex, i);
+                ++deletedCount;
+            }
+        }
+
+        // Check if any contact was found and deleted
+        if (deletedCount > 0)
+        {
+            std::cout << "\nContact '" << name << "' has been deleted." << std::endl;
+
+            // Rewrite the shard without tombstones once enough of them pile up
+            compactIfNeeded(shardIndex);
+        }
+        else
+        {
+            // No matching contact found for deletion
+            std::cout << "\nNo contact found with the given name." << std::endl;
+        }
+    }
+
+    // Method to delete all contacts
+    void deleteAllContacts()
+    {
+        prepareForMutation();
+
+        if (contactCount() == 0)
+        {
+            std::cout << "\nPhonebook is already empty. No contacts to delete." << std::endl;
+            return;
+        }
+
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            Shard &shard = shards[i];
+            shard.contacts.clear();
+            shard.deleted.clear();
+            shard.freeSlots.clear();
+            shard.unindexedSlots.clear();
+            shard.unindexed.clear();
+            shard.unindexedBase = nullptr;
+            setNameIndex(i, nullptr);
+        }
+        touchFields(allContactFields);
+        std::cout << "\nAll contacts have been deleted." << std::endl;
+
+        // Save the empty phonebook to file
+        forEachShard([this](size_t i)
+                     { saveShard(i); });
+    }
+
+    // Validate every stored phone number and email in bulk and report how many records fail and why
+    void verifyContacts()
+    {
+        waitForBackgroundWork();
+
+        static const char *const reasons[] = {
+            "Phone number is not 10 characters long",
+            "Phone number contains characters other than digits",
+            "Email has no '@' or has it at the beginning or end",
+            "Email domain is not allowed",
+        };
+        const size_t reasonCount = sizeof(reasons) / sizeof(reasons[0]);
+
+        // Per shard: number of invalid records followed by one counter per failure reason
+        std::vector<std::vector<size_t>> counts(shards.size(), std::vector<size_t>(reasonCount + 1, 0));
+        forEachShard([this, &counts, reasonCount](size_t i)
+                     {
+            const Shard &shard = shards[i];
+            std::vector<std::uint8_t> failures(shard.contacts.size());
+            validateContacts(shard.contacts.data(), shard.contacts.size(), failures.data());
+            for (size_t slot = 0; slot < failures.size(); ++slot)
+            {
+                std::uint8_t recordFailures = shard.deleted[slot] ? 0 : failures[slot];
+                counts[i][0] += recordFailures != 0 ? 1 : 0;
+                for (size_t reason = 0; reason < reasonCount; ++reason)
+                {
+                    counts[i][reason + 1] += (recordFailures >> reason) & 1;
+                }
+            } });
+
+        std::vector<size_t> totals(reasonCount + 1, 0);
+        for (const std::vector<size_t> &shardCounts : counts)
+        {
+            for (size_t j = 0; j < totals.size(); ++j)
+            {
+                totals[j] += shardCounts[j];
+            }
+        }
+
+        std::cout << "\nVerified " << contactCount() << " contacts, " << totals[0] << " invalid." << std::endl;
+        for (size_t reason = 0; reason < reasonCount; ++reason)
+        {
+            if (totals[reason + 1] > 0)
+            {
+                std::cout << "  " << reasons[reason] << ": " << totals[reason + 1] << std::endl;
+            }
+        }
+    }
+
+    // Write all contacts, in name order, to a compressed snapshot; blocks are compressed in parallel
+    bool saveSnapshot(const char *filename)
+    {
+        waitForBackgroundWork();
+
+        std::vector<RecordId> ids = collectMatches([](const Contact &)
+                                                   { return true; });
+        size_t blockCount = (ids.size() + snapshotBlockRecords - 1) / snapshotBlockRecords;
+        std::vector<SnapshotBlock> blocks(blockCount);
+        std::vector<std::string> compressed(blockCount);
+        parallelFor(blockCount, [this, &ids, &blocks, &compressed](size_t b)
+                    {
+            size_t first = b * snapshotBlockRecords;
+            size_t count = std::min<size_t>(snapshotBlockRecords, ids.size() - first);
+            std::string raw;
+            for (size_t i = first; i < first + count; ++i)
+            {
+                serializeRecord(contactAt(ids[i]), raw);
+            }
+            lzCompress(raw, compressed[b]);
+            blocks[b] = SnapshotBlock{0, static_cast<std::uint32_t>(compressed[b].size()), static_cast<std::uint32_t>(raw.size()),
+                                      static_cast<std::uint32_t>(count), crc32(raw.data(), raw.size())}; });
+
+        std::string header(snapshotMagic, sizeof(snapshotMagic));
+        appendU32(header, snapshotBlockRecords);
+        appendU32(header, static_cast<std::uint32_t>(blockCount));
+        appendU64(header, ids.size());
+        std::uint64_t offset = snapshotHeaderSize + blockCount * snapshotIndexEntrySize + 4;
+        for (SnapshotBlock &block : blocks)
+        {
+            block.offset = offset;
+            offset += block.compressedSize;
+            appendU64(header, block.offset);
+            appendU32(header, block.compressedSize);
+            appendU32(header, block.rawSize);
+            appendU32(header, block.recordCount);
+            appendU32(header, block.checksum);
+        }
+        appendU32(header, crc32(header.data(), header.size()));
+
+        // Write next to the target and rename it into place, so an existing snapshot is never left half-written
+        std::string tempFile = std::string(filename) + ".tmp";
+        std::ofstream outFile(tempFile, std::ios::binary | std::ios::out);
+        if (!outFile)
+        {
+            std::cerr << "Error opening file for writing." << std::endl;
+            return false;
+        }
+        outFile.write(header.data(), header.size());
+        for (const std::string &block : compressed)
+        {
+            outFile.write(block.data(), block.size());
+        }
+        outFile.close();
+        if (!outFile)
+        {
+            std::cerr << "Error writing snapshot " << filename << "." << std::endl;
+            std::remove(tempFile.c_str());
+            return false;
+        }
+
+        // Windows does not rename over an existing file
+        if (std::rename(tempFile.c_str(), filename) != 0 &&
+            (std::remove(filename) != 0 || std::rename(tempFile.c_str(), filename) != 0))
+        {
+            std::cerr << "Error replacing snapshot " << filename << "." << std::endl;
+            std::remove(tempFile.c_str());
+            return false;
+        }
+
+        std::cout << "Saved " << ids.size() << " contacts in " << blockCount << " blocks to " << filename << " ("
+                  << ids.size() * sizeof(Contact) << " -> " << offset << " bytes)." << std::endl;
+        return true;
+    }
+
+    // Replace all contacts with those of a compressed snapshot, decoding its blocks in parallel
+    bool loadSnapshot(const char *filename)
+    {
+        waitForBackgroundWork();
+
+        std::ifstream inFile(filename, std::ios::binary | std::ios::in);
+        std::uint64_t recordCount;
+        std::uint32_t recordsPerBlock;
+        std::vector<SnapshotBlock> blocks;
+        if (!inFile || !readSnapshotIndex(inFile, recordCount, recordsPerBlock, blocks))
+        {
+            std::cerr << "Error reading snapshot." << std::endl;
+            return false;
+        }
+        inFile.close();
+
+        // Where every block's records go
+        std::vector<size_t> firstRecord(blocks.size() + 1, 0);
+        for (size_t b = 0; b < blocks.size(); ++b)
+        {
+            firstRecord[b + 1] = firstRecord[b] + blocks[b].recordCount;
+        }
+        if (firstRecord.back() != recordCount)
+        {
+            std::cerr << "Error reading snapshot." << std::endl;
+            return false;
+        }
+
+        std::vector<Contact> records(recordCount);
+        std::vector<char> blockValid(blocks.size(), false);
+        parallelFor(blocks.size(), [filename, &blocks, &firstRecord, &records, &blockValid](size_t b)
+                    {
+            std::ifstream blockFile(filename, std::ios::binary | std::ios::in);
+            blockValid[b] = readSnapshotBlock(blockFile, blocks[b], records.data() + firstRecord[b]); });
+
+        for (size_t b = 0; b < blocks.size(); ++b)
+        {
+            if (!blockValid[b])
+            {
+                std::cerr << "Snapshot block " << b << " is corrupt." << std::endl;
+                return false;
+            }
+        }
+
+        for (size_t i = 0; i < shards.size(); ++i)
+        {
+            Shard &shard = shards[i];
+            shard.contacts.clear();
+            shard.deleted.clear();
+            shard.freeSlots.clear();
+            shard.unindexedSlots.clear();
+            shard.unindexed.clear();
+            shard.unindexedBase = nullptr;
+            setNameIndex(i, nullptr);
+        }
+        for (const Contact &contact : records)
+        {
+            Shard &shard = shards[shardIndexFor(contact.name)];
+            shard.contacts.push_back(contact);
+            shard.deleted.push_back(false);
+        }
+        touchFields(allContactFields);
+
+        // Files of the layout on disk that the restored shards will not overwrite
+        staleFiles.clear();
+        for (const auto &file : recordedFiles(dataFile, manifestShards))
+        {
+            size_t count;
+            if (file.second != shards[file.first % shards.size()].filename && recordCountOf(file.second, count))
+            {
+                staleFiles.push_back(file.second);
+            }
+        }
+
+        std::vector<char> saved(shards.size(), false);
+        forEachShard([this, &saved](size_t i)
+                     {
+            saved[i] = saveShard(i);
+            buildNameIndex(i); });
+
+        // Keep the old files (and any pending rebalance) unless every shard file was written
+        if (std::find(saved.begin(), saved.end(), false) != saved.end() || !writeManifest())
+        {
+            std::cerr << "Error saving the restored contacts; old shard files were kept." << std::endl;
+            return false;
+        }
+
+        // Every shard file was just rewritten, so nothing is left to rebalance and files written with
+        // another shard count would only bring old contacts back
+        needsRebalance = false;
+        retireStaleFiles();
+
+        std::cout << "Restored " << records.size() << " contacts from " << filename << "." << std::endl;
+        return true;
+    }
+
+    // Method to sort all contacts by name: the name index of every shard is rebuilt in the background
+    void sortContactsByName()
+    {
+        waitForBackgroundWork();
+
+        // Cached results are in the old order
+        touchFields(allContactFields);
+        startBackgroundWork([this]()
+                            { forEachShard([this](size_t i)
+                                           { buildNameIndex(i); }); });
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    // Command line options:
+    //   --shards N           spread the contacts over N data files
+    //   --email-domains a,b  domains accepted in email addresses (default gmail.com,yahoo.com,email.com)
+    //   --verify             validate every stored contact, print a report and exit
+    //   --query-cache-mb N   memory budget for cached search results (default 16)
+    //   --save-snapshot F    write the contacts to the compressed snapshot F and exit
+    //   --load-snapshot F    replace the contacts with those of snapshot F and exit
+    //   --fetch-snapshot F N print record N of snapshot F, decoding only its block, and exit
+    size_t shardCount = 1;
+    const char *saveSnapshotFile = nullptr;
+    const char *loadSnapshotFile = nullptr;
+    const char *fetchSnapshotFile = nullptr;
+    std::uint64_t fetchIndex = 0;
+    size_t queryCacheMegabytes = 16;
+    bool verifyOnly = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--shards") == 0 && i + 1 < argc)
+        {
+            int requested = std::atoi(argv[++i]);
+            shardCount = requested > 0 ? static_cast<size_t>(requested) : 1;
+        }
+        else if (std::strcmp(argv[i], "--email-domains") == 0 && i + 1 < argc)
+        {
+            std::vector<std::string> domains;
+            std::string list = argv[++i];
+            for (std::string::size_type start = 0; start <= list.size();)
+            {
+                std::string::size_type comma = list.find(',', start);
+                if (comma == std::string::npos)
+                {
+                    comma = list.size();
+                }
+                if (comma > start)
+                {
+                    domains.push_back(list.substr(start, comma - start));
+                }
+                start = comma + 1;
+            }
+
+            // Without a domain no email could ever be accepted
+            if (domains.empty())
+            {
+                std::cerr << "Error: --email-domains needs at least one domain." << std::endl;
+                return 1;
+            }
+            if (domains.size() > DomainMatcher::maxDomains)
+            {
+                std::cerr << "Error: --email-domains accepts at most " << DomainMatcher::maxDomains << " domains." << std::endl;
+                return 1;
+            }
+            EmailField::setAllowedDomains(domains);
+        }
+        else if (std::strcmp(argv[i], "--verify") == 0)
+        {
+            verifyOnly = true;
+        }
+        else if (std::strcmp(argv[i], "--query-cache-mb") == 0 && i + 1 < argc)
+        {
+            int requested = std::atoi(argv[++i]);
+            queryCacheMegabytes = requested > 0 ? static_cast<size_t>(requested) : 0;
+        }
+        else if (std::strcmp(argv[i], "--save-snapshot") == 0 && i + 1 < argc)
+        {
+            saveSnapshotFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--load-snapshot") == 0 && i + 1 < argc)
+        {
+            loadSnapshotFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--fetch-snapshot") == 0 && i + 2 < argc)
+        {
+            fetchSnapshotFile = argv[++i];
+            fetchIndex = std::strtoull(argv[++i], nullptr, 10);
+        }
+    }
+
+    if (fetchSnapshotFile)
+    {
+        Contact contact;
+        if (!readSnapshotRecord(fetchSnapshotFile, fetchIndex, contact))
+        {
+            std::cerr << "Error reading record " << fetchIndex << " from snapshot." << std::endl;
+            return 1;
+        }
+        forEachField([&contact](auto field)
+                     { std::cout << decltype(field)::label << ": " << decltype(field)::data(contact) << std::endl; });
+        return 0;
+    }
+
+    if (loadSnapshotFile)
+    {
+        Phonebook phonebook(shardCount);
+        return phonebook.loadSnapshot(loadSnapshotFile) ? 0 : 1;
+    }
+
+    if (saveSnapshotFile)
+    {
+        Phonebook phonebook(shardCount);
+        phonebook.loadFromFile("contacts.dat");
+        return phonebook.saveSnapshot(saveSnapshotFile) ? 0 : 1;
+    }
+
+    if (verifyOnly)
+    {
+        Phonebook phonebook(shardCount);
+        phonebook.loadFromFile("contacts.dat");
+        phonebook.verifyContacts();
+        return 0;
+    }
+
+    system("color 0A");
+    Phonebook phonebook(shardCount);
+    phonebook.setQueryCacheBudget(queryCacheMegabytes * 1024 * 1024);
+
+    int choice;
+    std::string searchName;
+    std::string partialPhoneNo;
+    std::string searchGroup;
+    std::string modifyName;
+    std::string deleteName;
+
+    // Load existing contacts from the file; the menu is usable while loading and sorting finish in the background
+    phonebook.startLoading("contacts.dat");
+
+    do
+    {
+        clearScreen();
+        displayMenu();
+        phonebook.printStatus();
+
+        // Getting user's choice
+        std::cout << "Enter your choice: ";
+        std::cin >> choice;
+
+        if (std::cin.fail())
+        {
+            clearScreen();
+            std::cout << "Invalid choice. Please enter a valid option.\n";
+            sleepForOneSecond(1);
+            clearInputBuffer(); // Clear input buffer
+            continue;
+        }
+
+        clearInputBuffer(); // Clear input buffer after reading choice
+
+        switch (choice)
+        {
+        case 1:
+            // Show all contacts
+            phonebook.printContacts();
+            std::cout << "\n\n-> Press any key to continue : ";
+            getch();
+            break;
+        case 2:
+            // Search by Name
+            std::cout << "Enter name to search: ";
+            std::getline(std::cin, searchName);
+            phonebook.searchByName(searchName);
+            std::cout << "\n\n-> Press any key to continue : ";
+            getch();
+            break;
+        case 3:
+            // Search by Partial Phone Number
+            std::cout << "Enter partial phone number to search: ";
+            std::getline(std::cin, partialPhoneNo);
+            phonebook.searchByPhoneNumber(partialPhoneNo);
+            std::cout << "\n\n-> Press any key to continue : ";
+            getch();
+            break;
+        case 4:
+            // Search by Group
+            std::cout << "Enter group to search: ";
+            std::getline(std::cin, searchGroup);
+            phonebook.searchByGroup(searchGroup);
+            std::cout << "\n\n-> Press any key to continue : ";
+            getch();
+            break;
+        case 5:
+            // Add a new contact
+            phonebook.addContactFromUserInput();
+            break;
+        case 6:
+            // Modify a contact
+            std::cout << "Enter the name of the contact to modify: ";
+            std::getline(std::cin, modifyName);
+            phonebook.modifyContact(modifyName);
+            std::cout << "\n\n-> Press any key to continue : ";
+            getch();
+            break;
+        case 7:
+            // Delete a contact
+            std::cout << "Enter the name of the contact to delete: ";
+            std::getline(std::cin, deleteName);
+            phonebook.deleteContact(deleteName);
+            std::cout << "\n\n-> Press any key to continue : ";
+            getch();
+            break;
+        case 8:
+            // Delete all contacts
+            phonebook.deleteAllContacts();
+            std::cout << "\n\n-> Press any key to continue : ";
+            getch();
+            break;
+        case 9:
+            // Sort contacts by name
+            phonebook.sortContactsByName();
+            std::cout << "\nSorting contacts by name in the background." << std::endl;
+            std::cout << "\n\n-> Press any key to continue : ";
+            getch();
+            break;
+        case 10:
+            // Exit the program
+            clearScreen();
+            std::cout << "\n\n---------Exiting the Phonebook---------\n\n";
+            sleepForOneSecond(1);
+            break;
+        default:
+            clearScreen();
+            std::cout << "Invalid choice. Please enter a valid option.\n";
+            sleepForOneSecond(1);
+            break;
+        }
+    } while (choice != 10);
+
+    return 0;
+}